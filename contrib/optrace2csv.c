@@ -0,0 +1,127 @@
+/* -*- mode: c; c-basic-offset: 8; indent-tabs-mode: nil; -*-
+ * vim:expandtab:shiftwidth=8:tabstop=8:
+ */
+/******************************************************************************\
+*
+* Purpose:
+*       Converts the binary per-operation traces written with savePerOpDataCSV
+*       into CSV, one line per operation:
+*         time,runtime,tp,offset,size
+*       with the start time and latency in seconds and the throughput in
+*       bytes per second.  See OpTimer in src/utilities.c for the format.
+*
+* Usage:
+*       optrace2csv <trace file> [<trace file> ...]
+*       Multiple traces are written one after another with a single header,
+*       an additional leading "file" column names the trace of each line.
+*
+\******************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_MAGIC "IORTRACE"
+#define TRACE_VERSION 1
+#define TRACE_HEADER_SIZE 24
+
+/* returns 0 at the end of the file, -1 if the varint is truncated */
+static int get_varint(FILE *fd, uint64_t *value)
+{
+        uint64_t v = 0;
+        int shift = 0;
+        int c;
+
+        while ((c = fgetc(fd)) != EOF) {
+                v |= (uint64_t) (c & 0x7f) << shift;
+                if ((c & 0x80) == 0) {
+                        *value = v;
+                        return 1;
+                }
+                shift += 7;
+                if (shift > 63)
+                        return -1;
+        }
+        return shift == 0 ? 0 : -1;
+}
+
+static int64_t unzigzag(uint64_t v)
+{
+        return (int64_t) (v >> 1) ^ -(int64_t) (v & 1);
+}
+
+/* returns the number of operations, -1 on error */
+static long long convert(const char *name, int print_name)
+{
+        unsigned char header[TRACE_HEADER_SIZE];
+        FILE *fd = fopen(name, "rb");
+        if (fd == NULL) {
+                fprintf(stderr, "Cannot open %s: %s\n", name, strerror(errno));
+                return -1;
+        }
+        if (fread(header, sizeof(header), 1, fd) != 1
+            || memcmp(header, TRACE_MAGIC, 8) != 0) {
+                fprintf(stderr, "%s is not a trace file\n", name);
+                fclose(fd);
+                return -1;
+        }
+        uint32_t version = 0;
+        for (int i = 0; i < 4; i++)
+                version |= (uint32_t) header[8 + i] << (8 * i);
+        if (version != TRACE_VERSION) {
+                fprintf(stderr, "%s has the unsupported version %u\n", name, version);
+                fclose(fd);
+                return -1;
+        }
+
+        long long ops = 0;
+        int64_t time = 0;
+        int64_t next_offset = 0;
+        uint64_t v[4];
+        while (1) {
+                int ret = get_varint(fd, &v[0]);
+                if (ret == 0)
+                        break;
+                for (int i = 1; i < 4 && ret == 1; i++)
+                        ret = get_varint(fd, &v[i]);
+                if (ret != 1) {
+                        fprintf(stderr, "%s is truncated after %lld operations\n", name, ops);
+                        fclose(fd);
+                        return -1;
+                }
+                time += unzigzag(v[0]);
+                int64_t offset = next_offset + unzigzag(v[2]);
+                next_offset = offset + (int64_t) v[3];
+                double runtime = v[1] * 1e-9;
+                if (print_name)
+                        printf("%s,", name);
+                printf("%.9f,%.9e,%e,%lld,%llu\n", time * 1e-9, runtime,
+                       runtime > 0 ? v[3] / runtime : 0.0,
+                       (long long) offset, (unsigned long long) v[3]);
+                ops++;
+        }
+        fclose(fd);
+        return ops;
+}
+
+int main(int argc, char **argv)
+{
+        int errors = 0;
+
+        if (argc < 2) {
+                fprintf(stderr, "Usage: %s <trace file> [<trace file> ...]\n", argv[0]);
+                return 1;
+        }
+        printf("%stime,runtime,tp,offset,size\n", argc > 2 ? "file," : "");
+        for (int i = 1; i < argc; i++) {
+                if (convert(argv[i], argc > 2) < 0)
+                        errors++;
+        }
+        return errors != 0;
+}
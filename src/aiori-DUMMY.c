@@ -149,6 +149,35 @@ static IOR_offset_t DUMMY_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer
   return length;
 }
 
+/* completed but not yet reaped asynchronous requests of the calling thread */
+static __thread aiori_xfer_req_t ** completed_reqs = NULL;
+static __thread int completed_count = 0;
+static __thread int completed_size = 0;
+
+static int DUMMY_xfer_submit(aiori_fd_t *file, aiori_xfer_req_t * req, aiori_mod_opt_t * options){
+  req->transferred = DUMMY_Xfer(req->access, file, req->buffer, req->length, req->offset, options);
+  if(completed_count == completed_size){
+    completed_size = completed_size == 0 ? 16 : completed_size * 2;
+    completed_reqs = realloc(completed_reqs, sizeof(aiori_xfer_req_t *) * completed_size);
+    if(completed_reqs == NULL){
+      ERR("DUMMY out of memory");
+    }
+  }
+  completed_reqs[completed_count++] = req;
+  return 0;
+}
+
+static int DUMMY_xfer_poll(aiori_fd_t *file, aiori_xfer_req_t ** completed, int max, aiori_mod_opt_t * options){
+  int count = completed_count < max ? completed_count : max;
+  completed_count -= count;
+  memcpy(completed, completed_reqs + completed_count, sizeof(aiori_xfer_req_t *) * count);
+  return count;
+}
+
+static int DUMMY_xfer_wait(aiori_fd_t *file, aiori_xfer_req_t ** completed, int min, int max, aiori_mod_opt_t * options){
+  return DUMMY_xfer_poll(file, completed, max, options);
+}
+
 static int DUMMY_statfs (const char * path, ior_aiori_statfs_t * stat, aiori_mod_opt_t * options){
   stat->f_bsize = 1;
   stat->f_blocks = 1;
@@ -175,6 +204,38 @@ static int DUMMY_stat (const char *path, struct stat *buf, aiori_mod_opt_t * opt
   return 0;
 }
 
+/* a bulk call is a single round trip, it is delayed once like a single create */
+static int DUMMY_bulk_create(char ** paths, int count, int iorflags, int * results, aiori_mod_opt_t * options){
+  if(verbose > 4){
+    fprintf(out_logfile, "DUMMY bulk create: %d files, first %s\n", count, paths[0]);
+  }
+  dummy_options_t * o = (dummy_options_t*) options;
+  if (o->delay_creates){
+    if (! o->delay_rank_0_only || (o->delay_rank_0_only && rank == 0)){
+      struct timespec wait = { o->delay_creates / 1000 / 1000, 1000l * (o->delay_creates % 1000000)};
+      nanosleep( & wait, NULL);
+    }
+  }
+  memset(results, 0, sizeof(int) * count);
+  return 0;
+}
+
+static int DUMMY_bulk_stat(char ** paths, int count, struct stat * bufs, int * results, aiori_mod_opt_t * options){
+  if(verbose > 4){
+    fprintf(out_logfile, "DUMMY bulk stat: %d paths, first %s\n", count, paths[0]);
+  }
+  memset(results, 0, sizeof(int) * count);
+  return 0;
+}
+
+static int DUMMY_bulk_remove(char ** paths, int count, int * results, aiori_mod_opt_t * options){
+  if(verbose > 4){
+    fprintf(out_logfile, "DUMMY bulk remove: %d paths, first %s\n", count, paths[0]);
+  }
+  memset(results, 0, sizeof(int) * count);
+  return 0;
+}
+
 static int DUMMY_rename (const char *path, const char *path2, aiori_mod_opt_t * options){
   return 0;
 }
@@ -204,6 +265,9 @@ ior_aiori_t dummy_aiori = {
         .create = DUMMY_Create,
         .open = DUMMY_Open,
         .xfer = DUMMY_Xfer,
+        .xfer_submit = DUMMY_xfer_submit,
+        .xfer_poll = DUMMY_xfer_poll,
+        .xfer_wait = DUMMY_xfer_wait,
         .close = DUMMY_Close,
         .remove = DUMMY_Delete,
         .get_version = DUMMY_getVersion,
@@ -215,10 +279,14 @@ ior_aiori_t dummy_aiori = {
         .rename = DUMMY_rename,
         .access = DUMMY_access,
         .stat = DUMMY_stat,
+        .bulk_create = DUMMY_bulk_create,
+        .bulk_stat = DUMMY_bulk_stat,
+        .bulk_remove = DUMMY_bulk_remove,
         .initialize = DUMMY_init,
         .finalize = DUMMY_final,
         .get_options = DUMMY_options,
         .check_params = DUMMY_check_params,
         .sync = DUMMY_Sync,
-        .enable_mdtest = true
+        .enable_mdtest = true,
+        .thread_safe = true
 };
@@ -83,7 +83,7 @@
 
 /**************************** P R O T O T Y P E S *****************************/
 
-static IOR_offset_t SeekOffset(void *, IOR_offset_t, aiori_mod_opt_t *);
+static IOR_offset_t SeekOffset(void *, IOR_offset_t, hid_t, aiori_mod_opt_t *);
 static aiori_fd_t *HDF5_Create(char *, int flags, aiori_mod_opt_t *);
 static aiori_fd_t *HDF5_Open(char *, int flags, aiori_mod_opt_t *);
 static IOR_offset_t HDF5_Xfer(int, aiori_fd_t *, IOR_size_t *,
@@ -101,6 +101,11 @@ static int HDF5_Stat(const char *, struct stat *, aiori_mod_opt_t *);
 static void HDF5_Finalize(aiori_mod_opt_t *);
 static void HDF5_init_xfer_options(aiori_xfer_hint_t * params);
 static int HDF5_check_params(aiori_mod_opt_t * options);
+static int HDF5_filters_data(aiori_mod_opt_t * options);
+static int HDF5_xfer_submit(aiori_fd_t *, aiori_xfer_req_t *, aiori_mod_opt_t *);
+static int HDF5_xfer_poll(aiori_fd_t *, aiori_xfer_req_t **, int, aiori_mod_opt_t *);
+static int HDF5_xfer_wait(aiori_fd_t *, aiori_xfer_req_t **, int, int, aiori_mod_opt_t *);
+static int HDF5_xfer_depth(aiori_mod_opt_t *);
 
 /************************** O P T I O N S *****************************/
 typedef struct{
@@ -111,6 +116,15 @@ typedef struct{
   int noFill;                      /* no fill in file creation */
   IOR_offset_t setAlignment;       /* alignment in bytes */
   int chunk_size;
+  int shuffle;                     /* filter pipeline of chunked data sets */
+  int deflate;
+  int szip;
+  char * filters;                  /* further filters: id[:value...][,id...] */
+  int fletcher32;
+  IOR_offset_t chunk_cache_size;   /* bytes of the raw data chunk cache */
+  int chunk_cache_slots;
+  int async;                       /* transfers in flight in an event set */
+  int multi_dataset;               /* transfers per H5Dwrite_multi()/H5Dread_multi() */
 } HDF5_options_t;
 /***************************** F U N C T I O N S ******************************/
 
@@ -139,7 +153,20 @@ static option_help * HDF5_options(aiori_mod_opt_t ** init_backend_options, aiori
     {0, "hdf5.individualDataSets",        "Datasets not shared by all procs [not working]", OPTION_FLAG, 'd', & o->individualDataSets},
     {0, "hdf5.setAlignment",        "HDF5 alignment in bytes (e.g.: 8, 4k, 2m, 1g)", OPTION_OPTIONAL_ARGUMENT, 'd', & o->setAlignment},
     {0, "hdf5.noFill", "No fill in HDF5 file creation", OPTION_FLAG, 'd', & o->noFill},
-    {0, "hdf5.chunkSize", "Chunk size (in terms of dataset elements) to use for I/O", OPTION_FLAG, 'd', & o->chunk_size},
+    {0, "hdf5.chunkSize", "Chunk size (in terms of dataset elements) to use for I/O", OPTION_OPTIONAL_ARGUMENT, 'd', & o->chunk_size},
+    {0, "hdf5.shuffle", "Apply the shuffle filter to chunked data sets", OPTION_FLAG, 'd', & o->shuffle},
+    {0, "hdf5.deflate", "Compress chunked data sets with deflate at level N (1-9)", OPTION_OPTIONAL_ARGUMENT, 'd', & o->deflate},
+    {0, "hdf5.szip", "Compress chunked data sets with szip using N pixels per block", OPTION_OPTIONAL_ARGUMENT, 'd', & o->szip},
+    {0, "hdf5.filters", "Further filters of chunked data sets by ID with optional client data, e.g., 32001:0:0:0:0:5:1:1,32004", OPTION_OPTIONAL_ARGUMENT, 's', & o->filters},
+    {0, "hdf5.fletcher32", "Add Fletcher32 checksums to chunked data sets", OPTION_FLAG, 'd', & o->fletcher32},
+    {0, "hdf5.chunkCacheSize", "Size of the raw data chunk cache per data set in bytes (e.g.: 1m, 64m)", OPTION_OPTIONAL_ARGUMENT, 'l', & o->chunk_cache_size},
+    {0, "hdf5.chunkCacheSlots", "Number of hash slots of the raw data chunk cache", OPTION_OPTIONAL_ARGUMENT, 'd', & o->chunk_cache_slots},
+#ifdef HAVE_H5ESCREATE
+    {0, "hdf5.async", "Keep up to N transfers in flight with H5Dwrite_async()/H5Dread_async() and an event set", OPTION_OPTIONAL_ARGUMENT, 'd', & o->async},
+#endif
+#ifdef HAVE_H5DWRITE_MULTI
+    {0, "hdf5.multiDataset", "Batch N transfers into one H5Dwrite_multi()/H5Dread_multi() call", OPTION_OPTIONAL_ARGUMENT, 'd', & o->multi_dataset},
+#endif
     LAST_OPTION
   };
   option_help * help = malloc(sizeof(h));
@@ -156,6 +183,10 @@ ior_aiori_t hdf5_aiori = {
         .create = HDF5_Create,
         .open = HDF5_Open,
         .xfer = HDF5_Xfer,
+        .xfer_submit = HDF5_xfer_submit,
+        .xfer_poll = HDF5_xfer_poll,
+        .xfer_wait = HDF5_xfer_wait,
+        .xfer_depth = HDF5_xfer_depth,
         .close = HDF5_Close,
         .remove = HDF5_Delete,
         .get_version = HDF5_GetVersion,
@@ -169,7 +200,8 @@ ior_aiori_t hdf5_aiori = {
         .stat = HDF5_Stat,
         .finalize = HDF5_Finalize,
         .get_options = HDF5_options,
-        .check_params = HDF5_check_params
+        .check_params = HDF5_check_params,
+        .filters_data = HDF5_filters_data
 };
 
 typedef struct{
@@ -182,9 +214,21 @@ typedef struct{
   int newlyOpenedFile;            /* newly opened file */  
   int firstReadCheck;
   int startNewDataSet;
+  hid_t es;                       /* event set for hdf5.async */
+  aiori_xfer_req_t ** pending;    /* transfers batched for hdf5.multiDataset */
+  hid_t * pending_spaces;         /* their file data spaces */
+  int pending_count;
+  aiori_xfer_req_t ** in_flight;  /* transfers issued to the event set */
+  hid_t * in_flight_spaces;
+  int in_flight_count;
+  int in_flight_size;
+  aiori_xfer_req_t ** completed;  /* transfers not yet returned by xfer_poll() */
+  int completed_count;
+  int completed_size;
 } aiori_h5fd_t;
 
 static void SetupDataSet(aiori_h5fd_t *, int flags, aiori_mod_opt_t *);
+static int SetFilters(hid_t, const char *);
 
 /***************************** F U N C T I O N S ******************************/
 static aiori_xfer_hint_t * hints = NULL;
@@ -201,9 +245,32 @@ static int HDF5_check_params(aiori_mod_opt_t * options){
       ERR("alignment must be non-negative integer");
   if (o->individualDataSets)
       ERR("individual data sets not implemented");
+  if (o->async < 0 || o->multi_dataset < 0)
+      ERR("hdf5.async and hdf5.multiDataset must be non-negative");
+  if (o->chunk_size < 0)
+      ERR("chunk size must be non-negative integer");
+  if (o->deflate < 0 || o->deflate > 9)
+      ERR("hdf5.deflate must be a level between 0 and 9");
+  if (o->szip < 0 || o->szip > 32 || o->szip % 2 != 0)
+      ERR("hdf5.szip must be an even number of pixels per block up to 32");
+  if (o->filters && SetFilters(H5I_INVALID_HID, o->filters) != 0)
+      ERRF("invalid hdf5.filters \"%s\", expected id[:value...][,id...]", o->filters);
+  if ((o->shuffle || o->deflate || o->szip || o->filters || o->fletcher32) && o->chunk_size == 0)
+      ERR("HDF5 filters require hdf5.chunkSize");
+  /* parallel HDF5 writes filtered data sets of a shared file only collectively */
+  if ((o->shuffle || o->deflate || o->szip || o->filters || o->fletcher32)
+      && hints->numTasks > 1 && ! hints->filePerProc && ! hints->collective)
+      ERR("HDF5 filters on a shared file require collective I/O (-c)");
+  if (o->chunk_cache_size < 0 || o->chunk_cache_slots < 0)
+      ERR("hdf5.chunkCacheSize and hdf5.chunkCacheSlots must be non-negative");
   return 0;
 }
 
+static int HDF5_filters_data(aiori_mod_opt_t * options){
+  HDF5_options_t *o = (HDF5_options_t*) options;
+  return o->shuffle || o->deflate || o->szip || o->filters || o->fletcher32;
+}
+
 /*
  * Create and open a file through the HDF5 interface.
  */
@@ -226,6 +293,7 @@ static aiori_fd_t *HDF5_Open(char *testFileName, int flags, aiori_mod_opt_t * pa
         int tasksPerDataSet;
         unsigned fd_mode = (unsigned)0;
         aiori_h5fd_t * fd = safeMalloc(sizeof(aiori_h5fd_t));
+        memset(fd, 0, sizeof(aiori_h5fd_t));
         MPI_Comm comm;
         MPI_Info mpiHints = MPI_INFO_NULL;
 
@@ -395,17 +463,30 @@ static aiori_fd_t *HDF5_Open(char *testFileName, int flags, aiori_mod_opt_t * pa
         if (mpiHints != MPI_INFO_NULL)
                 MPI_Info_free(&mpiHints);
 
+        fd->es = H5I_INVALID_HID;
+#ifdef HAVE_H5ESCREATE
+        if (o->async > 0) {
+                fd->es = H5EScreate();
+                HDF5_CHECK(fd->es, "cannot create event set");
+        }
+#endif
+        if (o->multi_dataset > 1) {
+                fd->pending = safeMalloc(sizeof(aiori_xfer_req_t *) * o->multi_dataset);
+                fd->pending_spaces = safeMalloc(sizeof(hid_t) * o->multi_dataset);
+        }
+
         return (aiori_fd_t*)(fd);
 }
 
+static void HDF5_xfer_drain(aiori_h5fd_t *, aiori_mod_opt_t *);
+
 /*
- * Write or read access to file using the HDF5 interface.
+ * Select the data set for the transfer at offset, creating or opening the
+ * next data set at the start of a segment.  Returns FALSE for a dry run.
  */
-static IOR_offset_t HDF5_Xfer(int access, aiori_fd_t *afd, IOR_size_t * buffer,
-                              IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * param)
+static int HDF5_StartXfer(aiori_h5fd_t * fd, int access, IOR_offset_t offset, aiori_mod_opt_t * param)
 {
         IOR_offset_t segmentPosition, segmentSize;
-        aiori_h5fd_t * fd = (aiori_h5fd_t *) afd;
 
         /*
          * this toggle is for the read check operation, which passes through
@@ -443,12 +524,14 @@ static IOR_offset_t HDF5_Xfer(int access, aiori_fd_t *afd, IOR_size_t * buffer,
         }
 
         if(hints->dryRun)
-          return length;
+          return FALSE;
 
         /* create new data set */
         if (fd->startNewDataSet == TRUE) {
                 /* if just opened this file, no data set to close yet */
                 if (fd->newlyOpenedFile != TRUE) {
+                        /* transfers of the previous data set must finish first */
+                        HDF5_xfer_drain(fd, param);
                         HDF5_CHECK(H5Dclose(fd->dataSet), "cannot close data set");
                         HDF5_CHECK(H5Sclose(fd->fileDataSpace),
                                    "cannot close file data space");
@@ -456,11 +539,24 @@ static IOR_offset_t HDF5_Xfer(int access, aiori_fd_t *afd, IOR_size_t * buffer,
                 SetupDataSet(fd, access == WRITE ? IOR_CREAT : IOR_RDWR, param);
         }
 
-        SeekOffset(fd, offset, param);
-
         /* this is necessary to reset variables for reaccessing file */
         fd->startNewDataSet = FALSE;
         fd->newlyOpenedFile = FALSE;
+        return TRUE;
+}
+
+/*
+ * Write or read access to file using the HDF5 interface.
+ */
+static IOR_offset_t HDF5_Xfer(int access, aiori_fd_t *afd, IOR_size_t * buffer,
+                              IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * param)
+{
+        aiori_h5fd_t * fd = (aiori_h5fd_t *) afd;
+
+        if (! HDF5_StartXfer(fd, access, offset, param))
+                return length;
+
+        SeekOffset(fd, offset, fd->fileDataSpace, param);
 
         /* access the file */
         if (access == WRITE) {  /* WRITE */
@@ -477,12 +573,191 @@ static IOR_offset_t HDF5_Xfer(int access, aiori_fd_t *afd, IOR_size_t * buffer,
         return (length);
 }
 
+/*
+ * Asynchronous transfers: with hdf5.multiDataset, submitted transfers are
+ * batched until N are pending or the access or data set changes.  Every
+ * batch (or, without it, every transfer) is issued with a single call, with
+ * hdf5.async into the event set of the file.  An event set only reports when
+ * all of its operations finished, the transfers in flight thus complete
+ * together.  With the native VOL connector the asynchronous calls finish
+ * before returning.
+ */
+static void HDF5_xfer_complete(aiori_h5fd_t * fd, aiori_xfer_req_t * req)
+{
+        if (fd->completed_count == fd->completed_size) {
+                fd->completed_size = fd->completed_size == 0 ? 16 : fd->completed_size * 2;
+                fd->completed = realloc(fd->completed, sizeof(aiori_xfer_req_t *) * fd->completed_size);
+                if (fd->completed == NULL)
+                        ERR("HDF5 out of memory");
+        }
+        fd->completed[fd->completed_count++] = req;
+}
+
+/* complete the transfers of the event set, if block is FALSE only if all finished */
+static void HDF5_xfer_reap(aiori_h5fd_t * fd, int block)
+{
+#ifdef HAVE_H5ESCREATE
+        size_t in_progress = 0;
+        hbool_t failed = 0;
+
+        if (fd->in_flight_count == 0)
+                return;
+        HDF5_CHECK(H5ESwait(fd->es, block ? H5ES_WAIT_FOREVER : H5ES_WAIT_NONE,
+                            &in_progress, &failed),
+                   "cannot wait for event set");
+        if (in_progress > 0)
+                return;
+        for (int i = 0; i < fd->in_flight_count; i++) {
+                aiori_xfer_req_t * req = fd->in_flight[i];
+                req->transferred = failed ? -1 : req->length;
+                HDF5_CHECK(H5Sclose(fd->in_flight_spaces[i]), "cannot close file data space");
+                HDF5_xfer_complete(fd, req);
+        }
+        fd->in_flight_count = 0;
+#endif
+}
+
+/* issue the pending transfers with a single call */
+static void HDF5_xfer_flush(aiori_h5fd_t * fd, aiori_mod_opt_t * param)
+{
+        HDF5_options_t *o = (HDF5_options_t*) param;
+        int count = fd->pending_count;
+        herr_t ret = -1;
+
+        if (count == 0)
+                return;
+        int access = fd->pending[0]->access;
+        hid_t es = o->async > 0 ? fd->es : H5I_INVALID_HID;
+        if (count == 1) {
+                IOR_size_t * buffer = fd->pending[0]->buffer;
+                hid_t space = fd->pending_spaces[0];
+#ifdef HAVE_H5ESCREATE
+                if (es != H5I_INVALID_HID) {
+                        if (access == WRITE)
+                                ret = H5Dwrite_async(fd->dataSet, H5T_NATIVE_LLONG, fd->memDataSpace, space, fd->xferPropList, buffer, es);
+                        else
+                                ret = H5Dread_async(fd->dataSet, H5T_NATIVE_LLONG, fd->memDataSpace, space, fd->xferPropList, buffer, es);
+                } else
+#endif
+                if (access == WRITE)
+                        ret = H5Dwrite(fd->dataSet, H5T_NATIVE_LLONG, fd->memDataSpace, space, fd->xferPropList, buffer);
+                else
+                        ret = H5Dread(fd->dataSet, H5T_NATIVE_LLONG, fd->memDataSpace, space, fd->xferPropList, buffer);
+        } else {
+#ifdef HAVE_H5DWRITE_MULTI
+                hid_t dataSets[count], memTypes[count], memSpaces[count];
+                void * buffers[count];
+                for (int i = 0; i < count; i++) {
+                        dataSets[i] = fd->dataSet;
+                        memTypes[i] = H5T_NATIVE_LLONG;
+                        memSpaces[i] = fd->memDataSpace;
+                        buffers[i] = fd->pending[i]->buffer;
+                }
+#ifdef HAVE_H5ESCREATE
+                if (es != H5I_INVALID_HID) {
+                        if (access == WRITE)
+                                ret = H5Dwrite_multi_async(count, dataSets, memTypes, memSpaces, fd->pending_spaces, fd->xferPropList, (const void **) buffers, es);
+                        else
+                                ret = H5Dread_multi_async(count, dataSets, memTypes, memSpaces, fd->pending_spaces, fd->xferPropList, buffers, es);
+                } else
+#endif
+                if (access == WRITE)
+                        ret = H5Dwrite_multi(count, dataSets, memTypes, memSpaces, fd->pending_spaces, fd->xferPropList, (const void **) buffers);
+                else
+                        ret = H5Dread_multi(count, dataSets, memTypes, memSpaces, fd->pending_spaces, fd->xferPropList, buffers);
+#endif
+        }
+
+        for (int i = 0; i < count; i++) {
+                aiori_xfer_req_t * req = fd->pending[i];
+                if (ret >= 0 && es != H5I_INVALID_HID) {
+                        if (fd->in_flight_count == fd->in_flight_size) {
+                                fd->in_flight_size = fd->in_flight_size == 0 ? 16 : fd->in_flight_size * 2;
+                                fd->in_flight = realloc(fd->in_flight, sizeof(aiori_xfer_req_t *) * fd->in_flight_size);
+                                fd->in_flight_spaces = realloc(fd->in_flight_spaces, sizeof(hid_t) * fd->in_flight_size);
+                                if (fd->in_flight == NULL || fd->in_flight_spaces == NULL)
+                                        ERR("HDF5 out of memory");
+                        }
+                        fd->in_flight[fd->in_flight_count] = req;
+                        fd->in_flight_spaces[fd->in_flight_count++] = fd->pending_spaces[i];
+                        continue;
+                }
+                req->transferred = ret < 0 ? -1 : req->length;
+                HDF5_CHECK(H5Sclose(fd->pending_spaces[i]), "cannot close file data space");
+                HDF5_xfer_complete(fd, req);
+        }
+        fd->pending_count = 0;
+}
+
+/* issue the pending transfers and wait for all in flight */
+static void HDF5_xfer_drain(aiori_h5fd_t * fd, aiori_mod_opt_t * param)
+{
+        HDF5_xfer_flush(fd, param);
+        HDF5_xfer_reap(fd, TRUE);
+}
+
+static int HDF5_xfer_submit(aiori_fd_t *afd, aiori_xfer_req_t * req, aiori_mod_opt_t * param)
+{
+        HDF5_options_t *o = (HDF5_options_t*) param;
+        aiori_h5fd_t * fd = (aiori_h5fd_t *) afd;
+        int batch = o->multi_dataset > 1 ? o->multi_dataset : 1;
+
+        if ((o->async <= 0 && batch == 1) || hints->dryRun) {
+                req->transferred = HDF5_Xfer(req->access, afd, req->buffer, req->length, req->offset, param);
+                HDF5_xfer_complete(fd, req);
+                return 0;
+        }
+        if (fd->pending_count > 0 && fd->pending[0]->access != req->access)
+                HDF5_xfer_flush(fd, param);
+        HDF5_StartXfer(fd, req->access, req->offset, param);
+        if (fd->pending == NULL) {
+                fd->pending = safeMalloc(sizeof(aiori_xfer_req_t *));
+                fd->pending_spaces = safeMalloc(sizeof(hid_t));
+        }
+
+        /* every transfer in flight needs its own file data space */
+        hid_t space = H5Scopy(fd->fileDataSpace);
+        HDF5_CHECK(space, "cannot copy file data space");
+        SeekOffset(fd, req->offset, space, param);
+        fd->pending[fd->pending_count] = req;
+        fd->pending_spaces[fd->pending_count++] = space;
+        if (fd->pending_count >= batch)
+                HDF5_xfer_flush(fd, param);
+        return 0;
+}
+
+static int HDF5_xfer_poll(aiori_fd_t *afd, aiori_xfer_req_t ** completed, int max, aiori_mod_opt_t * param)
+{
+        aiori_h5fd_t * fd = (aiori_h5fd_t *) afd;
+        HDF5_xfer_reap(fd, FALSE);
+        int count = fd->completed_count < max ? fd->completed_count : max;
+        fd->completed_count -= count;
+        memcpy(completed, fd->completed + fd->completed_count, sizeof(aiori_xfer_req_t *) * count);
+        return count;
+}
+
+static int HDF5_xfer_wait(aiori_fd_t *afd, aiori_xfer_req_t ** completed, int min, int max, aiori_mod_opt_t * param)
+{
+        aiori_h5fd_t * fd = (aiori_h5fd_t *) afd;
+        if (fd->completed_count < min)
+                HDF5_xfer_drain(fd, param);
+        return HDF5_xfer_poll(afd, completed, max, param);
+}
+
+static int HDF5_xfer_depth(aiori_mod_opt_t * param)
+{
+        HDF5_options_t *o = (HDF5_options_t*) param;
+        int depth = o->async > 1 ? o->async : 1;
+        return o->multi_dataset > depth ? o->multi_dataset : depth;
+}
+
 /*
  * Perform fsync().
  */
 static void HDF5_Fsync(aiori_fd_t *afd, aiori_mod_opt_t * param)
 {
   aiori_h5fd_t * fd = (aiori_h5fd_t *) afd;
+  HDF5_xfer_drain(fd, param);
   HDF5_CHECK(H5Fflush(fd->fd, H5F_SCOPE_LOCAL), "cannot flush file to disk");
 }
 
@@ -494,6 +769,11 @@ static void HDF5_Close(aiori_fd_t *afd, aiori_mod_opt_t * param)
     aiori_h5fd_t * fd = (aiori_h5fd_t *) afd;
     if(hints->dryRun)
       return;
+    HDF5_xfer_drain(fd, param);
+#ifdef HAVE_H5ESCREATE
+    if (fd->es != H5I_INVALID_HID)
+            HDF5_CHECK(H5ESclose(fd->es), "cannot close event set");
+#endif
     //if (hints->fd_fppReadCheck == NULL) {
             HDF5_CHECK(H5Dclose(fd->dataSet), "cannot close data set");
             HDF5_CHECK(H5Sclose(fd->dataSpace), "cannot close data space");
@@ -505,6 +785,11 @@ static void HDF5_Close(aiori_fd_t *afd, aiori_mod_opt_t * param)
                        " cannot close transfer property list");
     //}
     HDF5_CHECK(H5Fclose(fd->fd), "cannot close file");
+    free(fd->pending);
+    free(fd->pending_spaces);
+    free(fd->in_flight);
+    free(fd->in_flight_spaces);
+    free(fd->completed);
     free(fd);
 }
 
@@ -567,7 +852,7 @@ static char * HDF5_GetVersion()
 /*
  * Seek to offset in file using the HDF5 interface and set up hyperslab.
  */
-static IOR_offset_t SeekOffset(void *afd, IOR_offset_t offset,
+static IOR_offset_t SeekOffset(void *afd, IOR_offset_t offset, hid_t fileSpace,
                                             aiori_mod_opt_t * param)
 {
     aiori_h5fd_t * fd = (aiori_h5fd_t *) afd;
@@ -595,7 +880,7 @@ static IOR_offset_t SeekOffset(void *afd, IOR_offset_t offset,
     hsBlock[0] = (hsize_t) (hints->transferSize / sizeof(IOR_size_t));
 
     /* select hyperslab in file data space */
-    HDF5_CHECK(H5Sselect_hyperslab(fd->fileDataSpace, H5S_SELECT_SET, hsStart, hsStride, hsCount, hsBlock),
+    HDF5_CHECK(H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, hsStart, hsStride, hsCount, hsBlock),
                "cannot select hyperslab");
     return (offset);
 }
@@ -609,6 +894,7 @@ static void SetupDataSet(aiori_h5fd_t *fd, int flags, aiori_mod_opt_t * param)
         HDF5_options_t *o = (HDF5_options_t*) param;
         char dataSetName[MAX_STR];
         hid_t dataSetPropList;
+        hid_t accessPropList = H5P_DEFAULT;
         int dataSetID;
         static int dataSetSuffix = 0;
 
@@ -628,6 +914,15 @@ static void SetupDataSet(aiori_h5fd_t *fd, int flags, aiori_mod_opt_t * param)
         sprintf(dataSetName, "%s-%04d.%04d", "Dataset", dataSetID,
                 dataSetSuffix++);
 
+        if (o->chunk_cache_size > 0) {
+                accessPropList = H5Pcreate(H5P_DATASET_ACCESS);
+                HDF5_CHECK(accessPropList, "cannot create data set access property list");
+                HDF5_CHECK(H5Pset_chunk_cache(accessPropList,
+                                              o->chunk_cache_slots > 0 ? o->chunk_cache_slots : H5D_CHUNK_CACHE_NSLOTS_DEFAULT,
+                                              o->chunk_cache_size, H5D_CHUNK_CACHE_W0_DEFAULT),
+                           "cannot set chunk cache");
+        }
+
         if (flags & IOR_CREAT) {     /* WRITE */
                 hsize_t chunk_dims[NUM_DIMS];
 
@@ -643,6 +938,23 @@ static void SetupDataSet(aiori_h5fd_t *fd, int flags, aiori_mod_opt_t * param)
 
                     HDF5_CHECK(H5Pset_chunk(dataSetPropList, NUM_DIMS, chunk_dims),
                         "cannot set chunk size");
+
+                    /* filter pipeline: shuffle, compression, checksums */
+                    if (o->shuffle)
+                            HDF5_CHECK(H5Pset_shuffle(dataSetPropList),
+                                       "cannot set shuffle filter");
+                    if (o->deflate > 0)
+                            HDF5_CHECK(H5Pset_deflate(dataSetPropList, o->deflate),
+                                       "cannot set deflate filter");
+                    if (o->szip > 0)
+                            HDF5_CHECK(H5Pset_szip(dataSetPropList, H5_SZIP_NN_OPTION_MASK, o->szip),
+                                       "cannot set szip filter");
+                    if (o->filters)
+                            HDF5_CHECK(SetFilters(dataSetPropList, o->filters),
+                                       "cannot set filter");
+                    if (o->fletcher32)
+                            HDF5_CHECK(H5Pset_fletcher32(dataSetPropList),
+                                       "cannot set fletcher32 filter");
                 }
 
                 if (o->noFill == TRUE) {
@@ -653,18 +965,60 @@ static void SetupDataSet(aiori_h5fd_t *fd, int flags, aiori_mod_opt_t * param)
                                                     H5D_FILL_TIME_NEVER),
                                    "cannot set fill time for property list");
                 }
-                fd->dataSet = H5Dcreate(fd->fd, dataSetName, H5T_NATIVE_LLONG, fd->dataSpace, dataSetPropList);
+                fd->dataSet = H5Dcreate2(fd->fd, dataSetName, H5T_NATIVE_LLONG, fd->dataSpace,
+                                         H5P_DEFAULT, dataSetPropList, accessPropList);
                 HDF5_CHECK(fd->dataSet, "cannot create data set");
+                HDF5_CHECK(H5Pclose(dataSetPropList), "cannot close data set creation property list");
         } else {                /* READ or CHECK */
-                fd->dataSet = H5Dopen(*(hid_t *) fd, dataSetName);
+                fd->dataSet = H5Dopen2(fd->fd, dataSetName, accessPropList);
                 HDF5_CHECK(fd->dataSet, "cannot open data set");
         }
+        if (accessPropList != H5P_DEFAULT)
+                HDF5_CHECK(H5Pclose(accessPropList), "cannot close data set access property list");
 
         /* retrieve data space from data set for hyperslab */
         fd->fileDataSpace = H5Dget_space(fd->dataSet);
         HDF5_CHECK(fd->fileDataSpace, "cannot get data space from data set");
 }
 
+/*
+ * Add the filters "id[:value...][,id...]" to the pipeline of a data set
+ * creation property list, e.g., for plugins.  With an invalid list only
+ * checks the syntax.  Returns 0 on success.
+ */
+static int SetFilters(hid_t dataSetPropList, const char * filters)
+{
+        const char * pos = filters;
+
+        while (*pos != 0) {
+                unsigned int values[32];
+                size_t count = 0;
+                char * end;
+                unsigned long id = strtoul(pos, & end, 10);
+
+                if (end == pos || id == 0)
+                        return -1;
+                pos = end;
+                while (*pos == ':') {
+                        if (count == sizeof(values) / sizeof(*values))
+                                return -1;
+                        values[count++] = strtoul(pos + 1, & end, 10);
+                        if (end == pos + 1)
+                                return -1;
+                        pos = end;
+                }
+                if (*pos == ',')
+                        pos++;
+                else if (*pos != 0)
+                        return -1;
+                if (dataSetPropList != H5I_INVALID_HID &&
+                    H5Pset_filter(dataSetPropList, (H5Z_filter_t) id, H5Z_FLAG_MANDATORY,
+                                  count, values) < 0)
+                        return -1;
+        }
+        return 0;
+}
+
 static IOR_offset_t HDF5_GetFileSize(aiori_mod_opt_t * test, char *testFileName)
 {
         /* Ensure that non-native VOLs do not use MPIIO_GetFileSize() */
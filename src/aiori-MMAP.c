@@ -11,6 +11,10 @@
 #  include "config.h"
 #endif
 
+#ifdef __linux__
+#  define _GNU_SOURCE             /* MAP_POPULATE, MAP_HUGETLB and madvise() */
+#endif                          /* __linux__ */
+
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -19,6 +23,7 @@
 #include <sys/stat.h>
 #include <sys/mman.h>
 #include <assert.h>
+#include <pthread.h>
 
 #include "ior.h"
 #include "aiori.h"
@@ -36,6 +41,8 @@ static void MMAP_Fsync(aiori_fd_t *, aiori_mod_opt_t *);
 static option_help * MMAP_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt_t * init_values);
 static void MMAP_xfer_hints(aiori_xfer_hint_t * params);
 static int MMAP_check_params(aiori_mod_opt_t * options);
+static void MMAP_Initialize(aiori_mod_opt_t * options);
+static void MMAP_Finalize(aiori_mod_opt_t * options);
 /************************** D E C L A R A T I O N S ***************************/
 
 ior_aiori_t mmap_aiori = {
@@ -50,18 +57,41 @@ ior_aiori_t mmap_aiori = {
         .fsync = MMAP_Fsync,
         .get_file_size = POSIX_GetFileSize,
         .get_options = MMAP_options,
-        .check_params = MMAP_check_params
+        .check_params = MMAP_check_params,
+        .initialize = MMAP_Initialize,
+        .finalize = MMAP_Finalize,
+        .thread_safe = true
 };
 
 /***************************** F U N C T I O N S ******************************/
 typedef struct{
-  int direct_io_ignored; /* this option is ignored */
-  void* mmap_ptr; /* for internal usage */
+  aiori_mod_opt_t * p;  /* posix options */
 
   int madv_dont_need;
   int madv_pattern;
+  long long window;     /* bytes mapped at a time, 0 maps the whole file */
+  long long prefetch;   /* bytes to MADV_WILLNEED ahead of sequential transfers */
+  int populate;         /* MAP_POPULATE */
+  int hugetlb;          /* MAP_HUGETLB */
+  int thp;              /* MADV_HUGEPAGE */
+  int touch;            /* read by summing the mapping in place */
 } mmap_options_t;
 
+/* a file and its current mapping */
+typedef struct{
+  aiori_fd_t * pfd;     /* the POSIX file */
+  int fd;
+  int prot;
+  IOR_offset_t size;    /* size of the file to map */
+  char * ptr;           /* the mapping, NULL if nothing is mapped */
+  IOR_offset_t map_offset;
+  IOR_offset_t map_length;
+  IOR_offset_t prefetched; /* end of the range advised with MADV_WILLNEED */
+  uint64_t checksum;    /* sum of the data read with mmap.touch */
+  pthread_rwlock_t map_lock; /* shared by transfers, exclusive to move the window */
+  pthread_mutex_t prefetch_lock; /* protects prefetched */
+} mmap_fd_t;
+
 static option_help * MMAP_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt_t * init_values){
   mmap_options_t * o = malloc(sizeof(mmap_options_t));
 
@@ -70,16 +100,28 @@ static option_help * MMAP_options(aiori_mod_opt_t ** init_backend_options, aiori
   }else{
     memset(o, 0, sizeof(mmap_options_t));
   }
-
+  option_help * p_help = POSIX_options((aiori_mod_opt_t**)& o->p, init_values == NULL ? NULL : (aiori_mod_opt_t*) ((mmap_options_t*)init_values)->p);
   *init_backend_options = (aiori_mod_opt_t*) o;
 
   option_help h [] = {
     {0, "mmap.madv_dont_need", "Use advise don't need", OPTION_FLAG, 'd', & o->madv_dont_need},
     {0, "mmap.madv_pattern", "Use advise to indicate the pattern random/sequential", OPTION_FLAG, 'd', & o->madv_pattern},
+    {0, "mmap.window", "Map windows of this size aligned to it instead of the whole file, a multiple of the page size", OPTION_OPTIONAL_ARGUMENT, 'l', & o->window},
+    {0, "mmap.prefetch", "Advise the kernel to read the bytes ahead of sequential transfers (MADV_WILLNEED)", OPTION_OPTIONAL_ARGUMENT, 'l', & o->prefetch},
+#ifdef MAP_POPULATE
+    {0, "mmap.populate", "Prefault the mapping (MAP_POPULATE)", OPTION_FLAG, 'd', & o->populate},
+#endif
+#ifdef MAP_HUGETLB
+    {0, "mmap.hugetlb", "Map with huge pages (MAP_HUGETLB), the file must reside on hugetlbfs", OPTION_FLAG, 'd', & o->hugetlb},
+#endif
+#ifdef MADV_HUGEPAGE
+    {0, "mmap.thp", "Advise transparent huge pages for the mapping (MADV_HUGEPAGE)", OPTION_FLAG, 'd', & o->thp},
+#endif
+    {0, "mmap.touch", "Read by summing the mapped data in place instead of copying it, data checks still copy it", OPTION_FLAG, 'd', & o->touch},
     LAST_OPTION
   };
-  option_help * help = malloc(sizeof(h));
-  memcpy(help, h, sizeof(h));
+  option_help * help = option_merge(h, p_help);
+  free(p_help);
   return help;
 }
 
@@ -91,41 +133,132 @@ static void MMAP_xfer_hints(aiori_xfer_hint_t * params){
 }
 
 static int MMAP_check_params(aiori_mod_opt_t * options){
-  if (hints->fsyncPerWrite && (hints->transferSize & (sysconf(_SC_PAGESIZE) - 1)))
+  mmap_options_t *o = (mmap_options_t*) options;
+  long pagesize = sysconf(_SC_PAGESIZE);
+  if (hints->fsyncPerWrite && (hints->transferSize & (pagesize - 1)))
     ERR("transfer size must be aligned with PAGESIZE for MMAP with fsyncPerWrite");
-  return 0;
+  if (o->window < 0 || o->window % pagesize != 0)
+    ERR("mmap.window must be a multiple of PAGESIZE");
+  if (o->prefetch < 0)
+    ERR("mmap.prefetch must not be negative");
+  return POSIX_check_params(o->p);
+}
+
+static void MMAP_Initialize(aiori_mod_opt_t * options){
+  mmap_options_t *o = (mmap_options_t*) options;
+  POSIX_Initialize(o->p);
 }
 
-static void ior_mmap_file(int *file, int mflags, void *param)
+static void MMAP_Finalize(aiori_mod_opt_t * options){
+  mmap_options_t *o = (mmap_options_t*) options;
+  POSIX_Finalize(o->p);
+}
+
+static void mmap_advise(void * addr, size_t length, int advice)
 {
-        int flags = PROT_READ;
-        IOR_offset_t size = hints->expectedAggFileSize;
+        if (posix_madvise(addr, length, advice) != 0)
+                ERR("madvise() failed");
+}
 
-        if (mflags & IOR_WRONLY || mflags & IOR_RDWR)
-                flags |= PROT_WRITE;
-        mmap_options_t *o = (mmap_options_t*) param;
+/* map length bytes of the file starting at offset */
+static void ior_mmap_file(mmap_fd_t * mfd, IOR_offset_t offset, IOR_offset_t length, mmap_options_t * o)
+{
+        int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+        if (o->populate)
+                flags |= MAP_POPULATE;
+#endif
+#ifdef MAP_HUGETLB
+        if (o->hugetlb)
+                flags |= MAP_HUGETLB;
+#endif
 
-        o->mmap_ptr = mmap(NULL, size, flags, MAP_SHARED,
-                               *file, 0);
-        if (o->mmap_ptr == MAP_FAILED)
-                ERR("mmap() failed");
+        mfd->ptr = mmap(NULL, length, mfd->prot, flags, mfd->fd, offset);
+        if (mfd->ptr == MAP_FAILED)
+                ERRF("mmap() of %lld bytes at offset %lld failed: %s",
+                     (long long) length, (long long) offset, strerror(errno));
+        mfd->map_offset = offset;
+        mfd->map_length = length;
+        mfd->prefetched = offset;
 
-        if (hints->randomOffset)
-                flags = POSIX_MADV_RANDOM;
-        else
-                flags = POSIX_MADV_SEQUENTIAL;
+        if (o->madv_pattern)
+                mmap_advise(mfd->ptr, length, hints->randomOffset ?
+                            POSIX_MADV_RANDOM : POSIX_MADV_SEQUENTIAL);
+        if (o->madv_dont_need)
+                mmap_advise(mfd->ptr, length, POSIX_MADV_DONTNEED);
+#ifdef MADV_HUGEPAGE
+        if (o->thp && madvise(mfd->ptr, length, MADV_HUGEPAGE) != 0)
+                WARNF("madvise(MADV_HUGEPAGE) failed: %s", strerror(errno));
+#endif
+}
 
-        if(o->madv_pattern){
-          if (posix_madvise(o->mmap_ptr, size, flags) != 0)
-          ERR("madvise() failed");
-        }
+static void ior_munmap_file(mmap_fd_t * mfd)
+{
+        if (mfd->ptr == NULL)
+                return;
+        if (munmap(mfd->ptr, mfd->map_length) != 0)
+                ERR("munmap failed");
+        mfd->ptr = NULL;
+}
 
-        if (o->madv_dont_need){
-          if (posix_madvise(o->mmap_ptr, size, POSIX_MADV_DONTNEED) != 0)
-          ERR("madvise() failed");
-        }
+static int mmap_in_window(mmap_fd_t * mfd, IOR_offset_t offset, IOR_offset_t length)
+{
+        return mfd->ptr != NULL && offset >= mfd->map_offset
+            && offset + length <= mfd->map_offset + mfd->map_length;
+}
+
+/* ensures that the range is mapped, moving the window if needed */
+static void mmap_window(mmap_fd_t * mfd, IOR_offset_t offset, IOR_offset_t length, mmap_options_t * o)
+{
+        if (mmap_in_window(mfd, offset, length))
+                return;
+        ior_munmap_file(mfd);
+        IOR_offset_t start = offset - offset % o->window;
+        IOR_offset_t end = start + o->window;
+        if (end < offset + length)
+                end = offset + length;
+        if (end > mfd->size)
+                end = mfd->size > offset + length ? mfd->size : offset + length;
+        ior_mmap_file(mfd, start, end - start, o);
+}
+
+/* advise the kernel to read up to o->prefetch bytes of the mapping after end */
+static void mmap_prefetch(mmap_fd_t * mfd, IOR_offset_t end, mmap_options_t * o)
+{
+        IOR_offset_t map_end = mfd->map_offset + mfd->map_length;
+        if (mfd->prefetched >= map_end || mfd->prefetched - end >= o->prefetch / 2)
+                return;
+        IOR_offset_t start = mfd->prefetched > end ? mfd->prefetched : end;
+        IOR_offset_t target = end + o->prefetch < map_end ? end + o->prefetch : map_end;
+        start -= (start - mfd->map_offset) % sysconf(_SC_PAGESIZE);
+        mmap_advise(mfd->ptr + (start - mfd->map_offset), target - start, POSIX_MADV_WILLNEED);
+        mfd->prefetched = target;
+}
+
+/* the size of the file to map, a file per process contains the blocks of one task */
+static IOR_offset_t mmap_file_size(void)
+{
+        if (hints->filePerProc && hints->randomOffset <= 1)
+                return hints->blockSize * hints->segmentCount;
+        return hints->expectedAggFileSize;
+}
 
-        return;
+static aiori_fd_t *mmap_setup(aiori_fd_t * pfd, int flags, aiori_mod_opt_t * param)
+{
+        mmap_options_t *o = (mmap_options_t*) param;
+        mmap_fd_t * mfd = safeMalloc(sizeof(mmap_fd_t));
+        memset(mfd, 0, sizeof(mmap_fd_t));
+        mfd->pfd = pfd;
+        mfd->fd = *(int *) pfd;
+        mfd->size = mmap_file_size();
+        mfd->prot = PROT_READ;
+        if (flags & IOR_WRONLY || flags & IOR_RDWR)
+                mfd->prot |= PROT_WRITE;
+        pthread_rwlock_init(& mfd->map_lock, NULL);
+        pthread_mutex_init(& mfd->prefetch_lock, NULL);
+        if (o->window == 0)
+                ior_mmap_file(mfd, 0, mfd->size, o);
+        return (aiori_fd_t *) mfd;
 }
 
 /*
@@ -133,13 +266,11 @@ static void ior_mmap_file(int *file, int mflags, void *param)
  */
 static aiori_fd_t *MMAP_Create(char *testFileName, int flags, aiori_mod_opt_t * param)
 {
-        int *fd;
-
-        fd = (int*) POSIX_Create(testFileName, flags, param);
-        if (ftruncate(*fd, hints->expectedAggFileSize) != 0)
+        mmap_options_t *o = (mmap_options_t*) param;
+        aiori_fd_t * pfd = POSIX_Create(testFileName, flags, o->p);
+        if (ftruncate(*(int *) pfd, mmap_file_size()) != 0)
                 ERR("ftruncate() failed");
-        ior_mmap_file(fd, flags, param);
-        return ((aiori_fd_t *)fd);
+        return mmap_setup(pfd, flags, param);
 }
 
 /*
@@ -147,10 +278,23 @@ static aiori_fd_t *MMAP_Create(char *testFileName, int flags, aiori_mod_opt_t *
  */
 static aiori_fd_t *MMAP_Open(char *testFileName, int flags, aiori_mod_opt_t * param)
 {
-        int *fd;
-        fd = (int*) POSIX_Open(testFileName, flags, param);
-        ior_mmap_file(fd, flags, param);
-        return ((aiori_fd_t *)fd);
+        mmap_options_t *o = (mmap_options_t*) param;
+        return mmap_setup(POSIX_Open(testFileName, flags, o->p), flags, param);
+}
+
+/* sum of the 64-bit words of the range, reading it without a copy */
+static uint64_t mmap_touch(const char * data, IOR_offset_t length)
+{
+        uint64_t sum = 0;
+        IOR_offset_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+                uint64_t v;
+                memcpy(& v, data + i, 8);
+                sum += v;
+        }
+        for (; i < length; i++)
+                sum += (unsigned char) data[i];
+        return sum;
 }
 
 /*
@@ -160,30 +304,57 @@ static IOR_offset_t MMAP_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer,
                                IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * param)
 {
         mmap_options_t *o = (mmap_options_t*) param;
+        mmap_fd_t * mfd = (mmap_fd_t *) file;
+        int prefetch = o->prefetch > 0 && ! hints->randomOffset;
+        /*
+         * Threads copy concurrently while the window stays mapped, a thread
+         * that has to move it keeps the exclusive lock for its own copy.
+         */
+        if (o->window > 0) {
+                pthread_rwlock_rdlock(& mfd->map_lock);
+                if (! mmap_in_window(mfd, offset, length)) {
+                        pthread_rwlock_unlock(& mfd->map_lock);
+                        pthread_rwlock_wrlock(& mfd->map_lock);
+                        mmap_window(mfd, offset, length, o);
+                }
+        }
+        char * ptr = mfd->ptr + (offset - mfd->map_offset);
+
         if (access == WRITE) {
-                memcpy(o->mmap_ptr + offset, buffer, length);
+                memcpy(ptr, buffer, length);
+        } else if (o->touch && access == READ) {
+                __atomic_fetch_add(& mfd->checksum, mmap_touch(ptr, length), __ATOMIC_RELAXED);
         } else {
-                memcpy(buffer, o->mmap_ptr + offset, length);
+                memcpy(buffer, ptr, length);
+        }
+        if (prefetch) {
+                pthread_mutex_lock(& mfd->prefetch_lock);
+                mmap_prefetch(mfd, offset + length, o);
+                pthread_mutex_unlock(& mfd->prefetch_lock);
         }
 
         if (hints->fsyncPerWrite == TRUE) {
-                if (msync(o->mmap_ptr + offset, length, MS_SYNC) != 0)
+                if (msync(ptr, length, MS_SYNC) != 0)
                         ERR("msync() failed");
-                if (posix_madvise(o->mmap_ptr + offset, length,
-                                  POSIX_MADV_DONTNEED) != 0)
-                        ERR("madvise() failed");
+                mmap_advise(ptr, length, POSIX_MADV_DONTNEED);
         }
+        if (o->window > 0)
+                pthread_rwlock_unlock(& mfd->map_lock);
         return (length);
 }
 
 /*
- * Perform msync().
+ * Perform msync(), with mmap.window also fsync() to flush the windows
+ * that were unmapped before.
  */
 static void MMAP_Fsync(aiori_fd_t *fd, aiori_mod_opt_t * param)
 {
         mmap_options_t *o = (mmap_options_t*) param;
-        if (msync(o->mmap_ptr, hints->expectedAggFileSize, MS_SYNC) != 0)
+        mmap_fd_t * mfd = (mmap_fd_t *) fd;
+        if (mfd->ptr != NULL && msync(mfd->ptr, mfd->map_length, MS_SYNC) != 0)
                 WARN("msync() failed");
+        if (o->window > 0)
+                POSIX_Fsync(mfd->pfd, o->p);
 }
 
 /*
@@ -192,8 +363,12 @@ static void MMAP_Fsync(aiori_fd_t *fd, aiori_mod_opt_t * param)
 static void MMAP_Close(aiori_fd_t *fd, aiori_mod_opt_t * param)
 {
         mmap_options_t *o = (mmap_options_t*) param;
-        if (munmap(o->mmap_ptr, hints->expectedAggFileSize) != 0)
-                ERR("munmap failed");
-        o->mmap_ptr = NULL;
-        POSIX_Close(fd, param);
+        mmap_fd_t * mfd = (mmap_fd_t *) fd;
+        ior_munmap_file(mfd);
+        if (o->touch && verbose >= VERBOSE_2)
+                INFOF("task %d: checksum of the touched data %llu\n", rank, (unsigned long long) mfd->checksum);
+        pthread_rwlock_destroy(& mfd->map_lock);
+        pthread_mutex_destroy(& mfd->prefetch_lock);
+        POSIX_Close(mfd->pfd, o->p);
+        free(mfd);
 }
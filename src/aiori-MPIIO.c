@@ -18,6 +18,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <strings.h>
 #include <sys/stat.h>
 
 #include "ior.h"
@@ -41,6 +42,13 @@ static void MPIIO_Close(aiori_fd_t *, aiori_mod_opt_t *);
 static char* MPIIO_GetVersion();
 static void MPIIO_Fsync(aiori_fd_t *, aiori_mod_opt_t *);
 static int MPIIO_check_params(aiori_mod_opt_t * options);
+static int MPIIO_xfer_submit(aiori_fd_t *, aiori_xfer_req_t *, aiori_mod_opt_t *);
+static int MPIIO_xfer_poll(aiori_fd_t *, aiori_xfer_req_t **, int, aiori_mod_opt_t *);
+static int MPIIO_xfer_wait(aiori_fd_t *, aiori_xfer_req_t **, int, int, aiori_mod_opt_t *);
+static int MPIIO_xfer_depth(aiori_mod_opt_t *);
+static int MPIIO_sweep_points(aiori_mod_opt_t *);
+static void MPIIO_sweep_select(aiori_mod_opt_t *, int);
+static int MPIIO_sweep_describe(aiori_mod_opt_t *, char *, char *, size_t);
 
 /************************** D E C L A R A T I O N S ***************************/
 
@@ -49,6 +57,12 @@ typedef struct{
   MPI_Datatype transferType;       /* datatype for transfer */
   MPI_Datatype contigType;         /* elem datatype */
   MPI_Datatype fileType;           /* filetype for file view */
+  MPI_Request * requests;          /* posted nonblocking transfers */
+  aiori_xfer_req_t ** pending;     /* their IOR requests */
+  int pending_count;
+  aiori_xfer_req_t ** completed;   /* not yet returned by xfer_poll() */
+  int completed_count;
+  int completed_size;
 } mpiio_fd_t;
 
 static option_help * MPIIO_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt_t * init_values){
@@ -67,6 +81,12 @@ static option_help * MPIIO_options(aiori_mod_opt_t ** init_backend_options, aior
     {0, "mpiio.useStridedDatatype", "put strided access into datatype", OPTION_FLAG, 'd', & o->useStridedDatatype},
     //{'P', NULL,        "useSharedFilePointer -- use shared file pointer [not working]", OPTION_FLAG, 'd', & params->useSharedFilePointer},
     {0, "mpiio.useFileView",  "Use MPI_File_set_view", OPTION_FLAG, 'd', & o->useFileView},
+    {0, "mpiio.nonblocking",  "Post N transfers with MPI_File_iwrite_at()/MPI_File_iread_at() and complete them with one MPI_Waitall()", OPTION_OPTIONAL_ARGUMENT, 'd', & o->nonblocking},
+    {0, "mpiio.icollective",  "Use the nonblocking collectives MPI_File_iwrite_at_all()/MPI_File_iread_at_all()", OPTION_FLAG, 'd', & o->icollective},
+    {0, "mpiio.splitCollective", "Use the split collectives MPI_File_write_at_all_begin()/_end(), one transfer in flight", OPTION_FLAG, 'd', & o->splitCollective},
+    {0, "mpiio.cbNodes",      "Number of collective buffering aggregators (cb_nodes), a list, e.g., 1,2,4, runs one test per value", OPTION_OPTIONAL_ARGUMENT, 's', & o->cbNodes},
+    {0, "mpiio.cbBufferSize", "Collective buffer size per aggregator (cb_buffer_size), a list, e.g., 1m,16m, runs one test per value", OPTION_OPTIONAL_ARGUMENT, 's', & o->cbBufferSize},
+    {0, "mpiio.cbMode",       "Two-phase collective buffering (romio_cb_write/romio_cb_read): enable, disable or automatic, a list runs one test per value", OPTION_OPTIONAL_ARGUMENT, 's', & o->cbMode},
       LAST_OPTION
   };
   option_help * help = malloc(sizeof(h));
@@ -83,6 +103,13 @@ ior_aiori_t mpiio_aiori = {
         .xfer_hints = MPIIO_xfer_hints,
         .open = MPIIO_Open,
         .xfer = MPIIO_Xfer,
+        .xfer_submit = MPIIO_xfer_submit,
+        .xfer_poll = MPIIO_xfer_poll,
+        .xfer_wait = MPIIO_xfer_wait,
+        .xfer_depth = MPIIO_xfer_depth,
+        .sweep_points = MPIIO_sweep_points,
+        .sweep_select = MPIIO_sweep_select,
+        .sweep_describe = MPIIO_sweep_describe,
         .close = MPIIO_Close,
         .remove = MPIIO_Delete,
         .get_version = MPIIO_GetVersion,
@@ -103,6 +130,40 @@ void MPIIO_xfer_hints(aiori_xfer_hint_t * params){
   hints = params;
 }
 
+/*
+ * Number of items in a comma separated list, 0 for an unset option.
+ */
+static int ListCount(const char * list)
+{
+        int count = 1;
+        if (list == NULL || *list == 0)
+                return 0;
+        for (; *list != 0; list++)
+                if (*list == ',')
+                        count++;
+        return count;
+}
+
+/*
+ * Copies item idx of a comma separated list into buf of size bytes.
+ */
+static void ListItem(const char * list, int idx, char * buf, size_t size)
+{
+        const char * item = list;
+        for (int i = 0; i < idx && item != NULL; i++) {
+                item = strchr(item, ',');
+                if (item != NULL)
+                        item++;
+        }
+        if (item == NULL)
+                ERRF("\"%s\" has no item %d", list, idx);
+        size_t len = strcspn(item, ",");
+        if (len >= size)
+                ERRF("\"%.*s\" of \"%s\" is too long", (int) len, item, list);
+        memcpy(buf, item, len);
+        buf[len] = 0;
+}
+
 static int MPIIO_check_params(aiori_mod_opt_t * module_options){
   mpiio_options_t * param = (mpiio_options_t*) module_options;
   if ((param->useFileView == TRUE)
@@ -120,10 +181,118 @@ static int MPIIO_check_params(aiori_mod_opt_t * module_options){
           ERR("random offset not available with collective MPIIO");
   if (hints->randomOffset && param->useFileView)
           ERR("random offset not available with MPIIO fileviews");
+  if (param->nonblocking < 0)
+          ERR("mpiio.nonblocking must be non-negative");
+  if ((param->nonblocking > 0 || param->icollective || param->splitCollective) && param->useFileView)
+          ERR("nonblocking MPIIO transfers are not available with fileviews");
+  if (param->icollective && param->splitCollective)
+          ERR("mpiio.icollective and mpiio.splitCollective are exclusive");
+  if (param->nonblocking > 1 && param->splitCollective)
+          ERR("a split collective keeps one transfer in flight, mpiio.nonblocking does not apply");
+#ifndef HAVE_MPI_FILE_IWRITE_AT_ALL
+  if (param->icollective)
+          ERR("mpiio.icollective requires MPI-3.1 nonblocking collective I/O");
+#endif
+  if (param->cbNodes && (ListCount(param->cbNodes) != 1 || atoi(param->cbNodes) < 1))
+          ERRF("mpiio.cbNodes \"%s\" must be a positive number", param->cbNodes);
+  if (param->cbBufferSize && (ListCount(param->cbBufferSize) != 1 || string_to_bytes(param->cbBufferSize) < 1))
+          ERRF("mpiio.cbBufferSize \"%s\" must be a positive size", param->cbBufferSize);
+  if (param->cbMode && strcasecmp(param->cbMode, "enable") != 0
+      && strcasecmp(param->cbMode, "disable") != 0
+      && strcasecmp(param->cbMode, "automatic") != 0)
+          ERRF("mpiio.cbMode \"%s\" must be enable, disable or automatic", param->cbMode);
 
   return 0;
 }
 
+/*
+ * Each combination of the cb_nodes, cb_buffer_size and collective buffering
+ * mode lists is one point of the sweep.
+ */
+static int MPIIO_sweep_points(aiori_mod_opt_t * module_options)
+{
+        mpiio_options_t * param = (mpiio_options_t*) module_options;
+        return MAX(ListCount(param->cbNodes), 1)
+               * MAX(ListCount(param->cbBufferSize), 1)
+               * MAX(ListCount(param->cbMode), 1);
+}
+
+static void MPIIO_sweep_select(aiori_mod_opt_t * module_options, int point)
+{
+        mpiio_options_t * param = (mpiio_options_t*) module_options;
+        char ** lists[] = {& param->cbNodes, & param->cbBufferSize, & param->cbMode};
+
+        for (int i = 0; i < 3; i++) {
+                int count = ListCount(*lists[i]);
+                if (count == 0)
+                        continue;
+                ListItem(*lists[i], point % count, param->cbSelected[i], sizeof(param->cbSelected[i]));
+                *lists[i] = param->cbSelected[i];
+                point /= count;
+        }
+}
+
+static int MPIIO_sweep_describe(aiori_mod_opt_t * module_options, char * requested, char * effective, size_t size)
+{
+        mpiio_options_t * param = (mpiio_options_t*) module_options;
+        if (! param->cbNodes && ! param->cbBufferSize && ! param->cbMode)
+                return 0;
+        snprintf(requested, size, "cb_nodes=%s cb_buffer_size=%s romio_cb=%s",
+                 param->cbNodes ? param->cbNodes : "-",
+                 param->cbBufferSize ? param->cbBufferSize : "-",
+                 param->cbMode ? param->cbMode : "-");
+        snprintf(effective, size, "cb_nodes=%s cb_buffer_size=%s romio_cb_write=%s romio_cb_read=%s",
+                 param->cbEffective[0], param->cbEffective[1],
+                 param->cbEffective[2], param->cbEffective[3]);
+        return 1;
+}
+
+/*
+ * Add the collective buffering hints of the options to the info object.
+ */
+static void SetCollectiveBufferingHints(MPI_Info mpiHints, mpiio_options_t * param)
+{
+        char value[32];
+
+        if (param->cbNodes)
+                MPI_CHECK(MPI_Info_set(mpiHints, "cb_nodes", param->cbNodes),
+                          "cannot set info object");
+        if (param->cbBufferSize) {
+                snprintf(value, sizeof(value), "%lld", (long long) string_to_bytes(param->cbBufferSize));
+                MPI_CHECK(MPI_Info_set(mpiHints, "cb_buffer_size", value),
+                          "cannot set info object");
+        }
+        if (param->cbMode) {
+                MPI_CHECK(MPI_Info_set(mpiHints, "romio_cb_write", param->cbMode),
+                          "cannot set info object");
+                MPI_CHECK(MPI_Info_set(mpiHints, "romio_cb_read", param->cbMode),
+                          "cannot set info object");
+        }
+}
+
+/*
+ * Remember the collective buffering hints the implementation applied to the
+ * file, "-" for the hints it does not report.
+ */
+static void GetCollectiveBufferingHints(MPI_File fd, mpiio_options_t * param)
+{
+        const char * keys[] = {"cb_nodes", "cb_buffer_size", "romio_cb_write", "romio_cb_read"};
+        MPI_Info info;
+        int flag;
+
+        if (! param->cbNodes && ! param->cbBufferSize && ! param->cbMode)
+                return;
+        MPI_CHECK(MPI_File_get_info(fd, &info), "cannot get file info");
+        for (int i = 0; i < 4; i++) {
+                MPI_CHECK(MPI_Info_get(info, keys[i], sizeof(param->cbEffective[i]) - 1,
+                                       param->cbEffective[i], &flag),
+                          "cannot get info object value");
+                if (! flag)
+                        strcpy(param->cbEffective[i], "-");
+        }
+        MPI_CHECK(MPI_Info_free(&info), "MPI_Info_free failed");
+}
+
 /*
  * Try to access a file through the MPIIO interface.
  */
@@ -219,6 +388,7 @@ static aiori_fd_t *MPIIO_Open(char *testFileName, int flags, aiori_mod_opt_t * m
         }
 
         SetHints(&mpiHints, param->hintsFileName);
+        SetCollectiveBufferingHints(mpiHints, param);
         /*
          * note that with MP_HINTS_FILTERED=no, all key/value pairs will
          * be in the info object.  The info object that is attached to
@@ -237,6 +407,7 @@ static aiori_fd_t *MPIIO_Open(char *testFileName, int flags, aiori_mod_opt_t * m
             if (flags & IOR_TRUNC) {
                 MPI_CHECKF(MPI_File_set_size(mfd->fd, 0), "cannot truncate file: %s", testFileName);
             }
+            GetCollectiveBufferingHints(mfd->fd, param);
         }
 
         /* show hints actually attached to file handle */
@@ -506,9 +677,10 @@ static IOR_offset_t MPIIO_Xfer(int access, aiori_fd_t * fdp, IOR_size_t * buffer
                                  * deal with us reporting that we wrote N times more
                                  * data than requested. */
                                 length = hints->transferSize;
-                                MPI_CHECK(MPI_Get_elements_x(&status, MPI_INT, &elementsAccessed),
+                                /* elements of the transfer type are IOR_size_t words */
+                                MPI_CHECK(MPI_Get_elements_x(&status, mfd->transferType, &elementsAccessed),
                                           "can't get elements accessed" );
-                                xferBytes = elementsAccessed * sizeof(MPI_BYTE);
+                                xferBytes = elementsAccessed * sizeof(IOR_size_t);
                         }
                 } else {
                         /*
@@ -548,7 +720,7 @@ static IOR_offset_t MPIIO_Xfer(int access, aiori_fd_t * fdp, IOR_size_t * buffer
                                                   "cannot access explicit, noncollective");
                                 }
                         }
-                        MPI_CHECK(MPI_Get_elements_x(&status, MPI_INT, &elementsAccessed),
+                        MPI_CHECK(MPI_Get_elements_x(&status, MPI_BYTE, &elementsAccessed),
                                    "can't get elements accessed" );
 
                         expectedBytes = length;
@@ -584,6 +756,155 @@ static IOR_offset_t MPIIO_Xfer(int access, aiori_fd_t * fdp, IOR_size_t * buffer
         return hints->transferSize; // short xfers already returned in the expectedBytes/retry check
 }
 
+/*
+ * Nonblocking transfers at explicit offsets: mpiio.nonblocking=N posts
+ * independent, with mpiio.icollective collective requests and completes
+ * every N of them with a single MPI_Waitall(); polling tests them as a
+ * group.  mpiio.splitCollective begins a split collective upon submission
+ * and ends it when IOR waits for it.  Every request owns its buffer of the
+ * transfer ring of IOR until it completes.
+ */
+static int MPIIO_nonblocking(mpiio_options_t * param)
+{
+        return param->nonblocking > 0 || param->icollective || param->splitCollective;
+}
+
+static void MPIIO_xfer_complete(mpiio_fd_t * mfd, aiori_xfer_req_t * req, MPI_Status * status)
+{
+        MPI_Count bytes = req->length;
+
+        if (status != NULL)
+                MPI_CHECK(MPI_Get_elements_x(status, MPI_BYTE, &bytes),
+                          "can't get elements accessed");
+        req->transferred = bytes;
+        if (mfd->completed_count == mfd->completed_size) {
+                mfd->completed_size = mfd->completed_size == 0 ? 16 : mfd->completed_size * 2;
+                mfd->completed = realloc(mfd->completed, sizeof(aiori_xfer_req_t *) * mfd->completed_size);
+                if (mfd->completed == NULL)
+                        ERR("realloc() failed");
+        }
+        mfd->completed[mfd->completed_count++] = req;
+}
+
+/* complete the posted transfers, if block is FALSE only if all finished */
+static void MPIIO_xfer_flush(mpiio_fd_t * mfd, mpiio_options_t * param, int block)
+{
+        int count = mfd->pending_count;
+        MPI_Status statuses[count > 0 ? count : 1];
+        int flag = 1;
+
+        if (count == 0)
+                return;
+        if (param->splitCollective) {
+                if (! block)
+                        return;
+                aiori_xfer_req_t * req = mfd->pending[0];
+                if (req->access == WRITE)
+                        MPI_CHECK(MPI_File_write_at_all_end(mfd->fd, req->buffer, &statuses[0]),
+                                  "cannot end split collective write");
+                else
+                        MPI_CHECK(MPI_File_read_at_all_end(mfd->fd, req->buffer, &statuses[0]),
+                                  "cannot end split collective read");
+        } else if (block) {
+                MPI_CHECK(MPI_Waitall(count, mfd->requests, statuses),
+                          "cannot wait for nonblocking transfers");
+        } else {
+                MPI_CHECK(MPI_Testall(count, mfd->requests, &flag, statuses),
+                          "cannot test nonblocking transfers");
+                if (! flag)
+                        return;
+        }
+        for (int i = 0; i < count; i++)
+                MPIIO_xfer_complete(mfd, mfd->pending[i], &statuses[i]);
+        mfd->pending_count = 0;
+}
+
+static int MPIIO_xfer_submit(aiori_fd_t *fdp, aiori_xfer_req_t * req, aiori_mod_opt_t * module_options)
+{
+        mpiio_options_t * param = (mpiio_options_t*) module_options;
+        mpiio_fd_t * mfd = (mpiio_fd_t*) fdp;
+        int depth = MPIIO_xfer_depth(module_options);
+        MPI_Request * request;
+
+        if (! MPIIO_nonblocking(param) || hints->dryRun) {
+                req->transferred = MPIIO_Xfer(req->access, fdp, req->buffer, req->length, req->offset, module_options);
+                MPIIO_xfer_complete(mfd, req, NULL);
+                return 0;
+        }
+        if (req->length > INT_MAX)
+                ERR("transfer size too large for nonblocking MPIIO transfers");
+        if (mfd->pending == NULL) {
+                mfd->pending = safeMalloc(sizeof(aiori_xfer_req_t *) * depth);
+                mfd->requests = safeMalloc(sizeof(MPI_Request) * depth);
+        }
+        /* a file handle has one split collective at a time, end it before the next one begins */
+        if (mfd->pending_count > 0 && (mfd->pending[0]->access != req->access || param->splitCollective))
+                MPIIO_xfer_flush(mfd, param, TRUE);
+
+        request = & mfd->requests[mfd->pending_count];
+        if (param->splitCollective) {
+                if (req->access == WRITE)
+                        MPI_CHECK(MPI_File_write_at_all_begin(mfd->fd, req->offset, req->buffer,
+                                                              req->length, MPI_BYTE),
+                                  "cannot begin split collective write");
+                else
+                        MPI_CHECK(MPI_File_read_at_all_begin(mfd->fd, req->offset, req->buffer,
+                                                             req->length, MPI_BYTE),
+                                  "cannot begin split collective read");
+#ifdef HAVE_MPI_FILE_IWRITE_AT_ALL
+        } else if (param->icollective) {
+                if (req->access == WRITE)
+                        MPI_CHECK(MPI_File_iwrite_at_all(mfd->fd, req->offset, req->buffer,
+                                                         req->length, MPI_BYTE, request),
+                                  "cannot post collective write");
+                else
+                        MPI_CHECK(MPI_File_iread_at_all(mfd->fd, req->offset, req->buffer,
+                                                        req->length, MPI_BYTE, request),
+                                  "cannot post collective read");
+#endif
+        } else {
+                if (req->access == WRITE)
+                        MPI_CHECK(MPI_File_iwrite_at(mfd->fd, req->offset, req->buffer,
+                                                     req->length, MPI_BYTE, request),
+                                  "cannot post write");
+                else
+                        MPI_CHECK(MPI_File_iread_at(mfd->fd, req->offset, req->buffer,
+                                                    req->length, MPI_BYTE, request),
+                                  "cannot post read");
+        }
+        mfd->pending[mfd->pending_count++] = req;
+        if (mfd->pending_count >= depth && ! param->splitCollective)
+                MPIIO_xfer_flush(mfd, param, TRUE);
+        return 0;
+}
+
+static int MPIIO_xfer_poll(aiori_fd_t *fdp, aiori_xfer_req_t ** completed, int max, aiori_mod_opt_t * module_options)
+{
+        mpiio_fd_t * mfd = (mpiio_fd_t*) fdp;
+        int count;
+
+        MPIIO_xfer_flush(mfd, (mpiio_options_t*) module_options, FALSE);
+        count = mfd->completed_count < max ? mfd->completed_count : max;
+        mfd->completed_count -= count;
+        memcpy(completed, mfd->completed + mfd->completed_count, sizeof(aiori_xfer_req_t *) * count);
+        return count;
+}
+
+static int MPIIO_xfer_wait(aiori_fd_t *fdp, aiori_xfer_req_t ** completed, int min, int max, aiori_mod_opt_t * module_options)
+{
+        mpiio_fd_t * mfd = (mpiio_fd_t*) fdp;
+
+        if (mfd->completed_count < min)
+                MPIIO_xfer_flush(mfd, (mpiio_options_t*) module_options, TRUE);
+        return MPIIO_xfer_poll(fdp, completed, max, module_options);
+}
+
+static int MPIIO_xfer_depth(aiori_mod_opt_t * module_options)
+{
+        mpiio_options_t * param = (mpiio_options_t*) module_options;
+        return param->nonblocking > 1 ? param->nonblocking : 1;
+}
+
 /*
  * Perform fsync().
  */
@@ -593,6 +914,7 @@ static void MPIIO_Fsync(aiori_fd_t *fdp, aiori_mod_opt_t * module_options)
   if(hints->dryRun)
     return;
   mpiio_fd_t * mfd = (mpiio_fd_t*) fdp;
+  MPIIO_xfer_flush(mfd, param, TRUE);
   if (MPI_File_sync(mfd->fd) != MPI_SUCCESS)
       WARN("fsync() failed");
 }
@@ -605,6 +927,7 @@ static void MPIIO_Close(aiori_fd_t *fdp, aiori_mod_opt_t * module_options)
         mpiio_options_t * param = (mpiio_options_t*) module_options;
         mpiio_fd_t * mfd = (mpiio_fd_t*) fdp;
         if(! hints->dryRun){
+              MPIIO_xfer_flush(mfd, param, TRUE);
               MPI_CHECK(MPI_File_close(& mfd->fd), "cannot close file");
         }
         if (param->useFileView == TRUE) {
@@ -615,6 +938,9 @@ static void MPIIO_Close(aiori_fd_t *fdp, aiori_mod_opt_t * module_options)
           MPI_CHECK(MPI_Type_free(& mfd->transferType), "cannot free MPI transfer datatype");
           MPI_CHECK(MPI_Type_free(& mfd->contigType), "cannot free type");
         }
+        free(mfd->requests);
+        free(mfd->pending);
+        free(mfd->completed);
         free(fdp);
 }
 
@@ -58,6 +58,11 @@ static char *NCMPI_GetVersion();
 static void NCMPI_Fsync(aiori_fd_t *, aiori_mod_opt_t *);
 static IOR_offset_t NCMPI_GetFileSize(aiori_mod_opt_t *, char *);
 static int NCMPI_Access(const char *, int, aiori_mod_opt_t *);
+static int NCMPI_check_params(aiori_mod_opt_t *);
+static int NCMPI_xfer_submit(aiori_fd_t *, aiori_xfer_req_t *, aiori_mod_opt_t *);
+static int NCMPI_xfer_poll(aiori_fd_t *, aiori_xfer_req_t **, int, aiori_mod_opt_t *);
+static int NCMPI_xfer_wait(aiori_fd_t *, aiori_xfer_req_t **, int, int, aiori_mod_opt_t *);
+static int NCMPI_xfer_depth(aiori_mod_opt_t *);
 
 /************************** D E C L A R A T I O N S ***************************/
 static aiori_xfer_hint_t * hints = NULL;
@@ -70,11 +75,18 @@ static void NCMPI_xfer_hints(aiori_xfer_hint_t * params){
 
 typedef struct {
   mpiio_options_t mpio;
+  int nonblocking;                 /* transfers posted per ncmpi_wait_all() */
 
   /* runtime variables */
   int var_id;                      /* variable id handle for data set */
   int firstReadCheck;
   int startDataSet;
+  aiori_xfer_req_t ** pending;     /* posted with ncmpi_iput/iget_vara() */
+  int * pending_ids;
+  int pending_count;
+  aiori_xfer_req_t ** completed;   /* not yet returned by xfer_poll() */
+  int completed_count;
+  int completed_size;
 } ncmpi_options_t;
 
 
@@ -93,6 +105,7 @@ static option_help * NCMPI_options(aiori_mod_opt_t ** init_backend_options, aior
     {0, "ncmpi.preallocate",   "Preallocate file size", OPTION_FLAG, 'd', & o->mpio.preallocate},
     {0, "ncmpi.useStridedDatatype", "put strided access into datatype", OPTION_FLAG, 'd', & o->mpio.useStridedDatatype},
     {0, "ncmpi.useFileView",  "Use MPI_File_set_view", OPTION_FLAG, 'd', & o->mpio.useFileView},
+    {0, "ncmpi.nonblocking",  "Post N transfers with ncmpi_iput_vara()/ncmpi_iget_vara() and complete them with one ncmpi_wait_all()", OPTION_OPTIONAL_ARGUMENT, 'd', & o->nonblocking},
     LAST_OPTION
   };
   option_help * help = malloc(sizeof(h));
@@ -106,6 +119,10 @@ ior_aiori_t ncmpi_aiori = {
         .create = NCMPI_Create,
         .open = NCMPI_Open,
         .xfer = NCMPI_Xfer,
+        .xfer_submit = NCMPI_xfer_submit,
+        .xfer_poll = NCMPI_xfer_poll,
+        .xfer_wait = NCMPI_xfer_wait,
+        .xfer_depth = NCMPI_xfer_depth,
         .close = NCMPI_Close,
         .remove = NCMPI_Delete,
         .get_version = NCMPI_GetVersion,
@@ -118,10 +135,20 @@ ior_aiori_t ncmpi_aiori = {
         .stat = aiori_posix_stat,
         .get_options = NCMPI_options,
         .xfer_hints = NCMPI_xfer_hints,
+        .check_params = NCMPI_check_params,
 };
 
 /***************************** F U N C T I O N S ******************************/
 
+static int NCMPI_check_params(aiori_mod_opt_t * param)
+{
+        ncmpi_options_t * o = (ncmpi_options_t*) param;
+
+        if (o->nonblocking < 0)
+                ERR("ncmpi.nonblocking must be non-negative");
+        return 0;
+}
+
 /*
  * Create and open a file through the NCMPI interface.
  */
@@ -216,14 +243,13 @@ static aiori_fd_t *NCMPI_Open(char *testFileName, int iorflags, aiori_mod_opt_t
 }
 
 /*
- * Write or read access to file using the NCMPI interface.
+ * Define or inquire the variable at the start of a data set and compute the
+ * start and count of the transfer at offset.  Returns the variable id.
  */
-static IOR_offset_t NCMPI_Xfer(int access, aiori_fd_t *fd, IOR_size_t * buffer, IOR_offset_t transferSize, IOR_offset_t offset, aiori_mod_opt_t * param)
+static int NCMPI_StartXfer(int access, aiori_fd_t *fd, IOR_offset_t transferSize, IOR_offset_t offset,
+                           MPI_Offset * offsets, MPI_Offset * bufSize, ncmpi_options_t * o)
 {
-        signed char *bufferPtr = (signed char *)buffer;
-        ncmpi_options_t * o = (ncmpi_options_t*) param;
         int var_id, dim_id[NUM_DIMS];
-        MPI_Offset bufSize[NUM_DIMS], offsets[NUM_DIMS];
         IOR_offset_t segmentPosition;
         int segmentNum, transferNum;
 
@@ -306,6 +332,19 @@ static IOR_offset_t NCMPI_Xfer(int access, aiori_fd_t *fd, IOR_size_t * buffer,
         offsets[1] = transferNum;
         offsets[2] = 0;
 
+        return var_id;
+}
+
+/*
+ * Write or read access to file using the NCMPI interface.
+ */
+static IOR_offset_t NCMPI_Xfer(int access, aiori_fd_t *fd, IOR_size_t * buffer, IOR_offset_t transferSize, IOR_offset_t offset, aiori_mod_opt_t * param)
+{
+        signed char *bufferPtr = (signed char *)buffer;
+        ncmpi_options_t * o = (ncmpi_options_t*) param;
+        MPI_Offset bufSize[NUM_DIMS], offsets[NUM_DIMS];
+        int var_id = NCMPI_StartXfer(access, fd, transferSize, offset, offsets, bufSize, o);
+
         /* access the file */
         if (access == WRITE) {  /* WRITE */
                 if (hints->collective) {
@@ -332,11 +371,120 @@ static IOR_offset_t NCMPI_Xfer(int access, aiori_fd_t *fd, IOR_size_t * buffer,
         return (transferSize);
 }
 
+/*
+ * Nonblocking transfers: requests are posted with ncmpi_iput_vara() or
+ * ncmpi_iget_vara() and completed with a single ncmpi_wait_all() once
+ * ncmpi.nonblocking are pending, which PnetCDF aggregates into one MPI-IO
+ * call, collective with -c.  Every request owns its buffer of the transfer
+ * ring of IOR until it completes.
+ */
+static void NCMPI_xfer_complete(ncmpi_options_t * o, aiori_xfer_req_t * req)
+{
+        if (o->completed_count == o->completed_size) {
+                o->completed_size = o->completed_size == 0 ? 16 : o->completed_size * 2;
+                o->completed = realloc(o->completed, sizeof(aiori_xfer_req_t *) * o->completed_size);
+                if (o->completed == NULL)
+                        ERR("realloc() failed");
+        }
+        o->completed[o->completed_count++] = req;
+}
+
+static void NCMPI_xfer_flush(aiori_fd_t *fd, ncmpi_options_t * o)
+{
+        int count = o->pending_count;
+        int statuses[count > 0 ? count : 1];
+
+        /* the collective wait needs every task, even without pending requests */
+        if (count == 0 && hints->collective == FALSE)
+                return;
+        if (hints->collective) {
+                NCMPI_CHECK(ncmpi_wait_all(*(int *)fd, count, o->pending_ids, statuses),
+                            "cannot wait for nonblocking requests");
+        } else {
+                NCMPI_CHECK(ncmpi_wait(*(int *)fd, count, o->pending_ids, statuses),
+                            "cannot wait for nonblocking requests");
+        }
+        for (int i = 0; i < count; i++) {
+                aiori_xfer_req_t * req = o->pending[i];
+                if (statuses[i] != NC_NOERR) {
+                        WARNF("nonblocking request failed: %s", ncmpi_strerror(statuses[i]));
+                        req->transferred = -1;
+                } else {
+                        req->transferred = req->length;
+                }
+                NCMPI_xfer_complete(o, req);
+        }
+        o->pending_count = 0;
+}
+
+static int NCMPI_xfer_submit(aiori_fd_t *fd, aiori_xfer_req_t * req, aiori_mod_opt_t * param)
+{
+        ncmpi_options_t * o = (ncmpi_options_t*) param;
+        MPI_Offset bufSize[NUM_DIMS], offsets[NUM_DIMS];
+
+        if (o->nonblocking <= 0) {
+                req->transferred = NCMPI_Xfer(req->access, fd, req->buffer, req->length, req->offset, param);
+                NCMPI_xfer_complete(o, req);
+                return 0;
+        }
+        if (o->pending == NULL) {
+                o->pending = safeMalloc(sizeof(aiori_xfer_req_t *) * o->nonblocking);
+                o->pending_ids = safeMalloc(sizeof(int) * o->nonblocking);
+        }
+        if (o->pending_count > 0 && o->pending[0]->access != req->access)
+                NCMPI_xfer_flush(fd, o);
+
+        int var_id = NCMPI_StartXfer(req->access, fd, req->length, req->offset, offsets, bufSize, o);
+        int * id = & o->pending_ids[o->pending_count];
+        if (req->access == WRITE) {
+                NCMPI_CHECK(ncmpi_iput_vara_schar(*(int *)fd, var_id, offsets, bufSize,
+                                                  (signed char *) req->buffer, id),
+                            "cannot post write to data set");
+        } else {
+                NCMPI_CHECK(ncmpi_iget_vara_schar(*(int *)fd, var_id, offsets, bufSize,
+                                                  (signed char *) req->buffer, id),
+                            "cannot post read from data set");
+        }
+        o->pending[o->pending_count++] = req;
+        if (o->pending_count >= o->nonblocking)
+                NCMPI_xfer_flush(fd, o);
+        return 0;
+}
+
+static int NCMPI_xfer_poll(aiori_fd_t *fd, aiori_xfer_req_t ** completed, int max, aiori_mod_opt_t * param)
+{
+        ncmpi_options_t * o = (ncmpi_options_t*) param;
+        int count = o->completed_count < max ? o->completed_count : max;
+
+        o->completed_count -= count;
+        memcpy(completed, o->completed + o->completed_count, sizeof(aiori_xfer_req_t *) * count);
+        return count;
+}
+
+static int NCMPI_xfer_wait(aiori_fd_t *fd, aiori_xfer_req_t ** completed, int min, int max, aiori_mod_opt_t * param)
+{
+        ncmpi_options_t * o = (ncmpi_options_t*) param;
+
+        if (o->completed_count < min)
+                NCMPI_xfer_flush(fd, o);
+        return NCMPI_xfer_poll(fd, completed, max, param);
+}
+
+static int NCMPI_xfer_depth(aiori_mod_opt_t * param)
+{
+        ncmpi_options_t * o = (ncmpi_options_t*) param;
+        return o->nonblocking > 1 ? o->nonblocking : 1;
+}
+
 /*
  * Perform fsync().
  */
 static void NCMPI_Fsync(aiori_fd_t *fd, aiori_mod_opt_t * param)
 {
+        ncmpi_options_t * o = (ncmpi_options_t*) param;
+
+        if (o->nonblocking > 0)
+                NCMPI_xfer_flush(fd, o);
         NCMPI_CHECK(ncmpi_sync(*(int *)fd), "cannot sync file");
 }
 
@@ -345,6 +493,18 @@ static void NCMPI_Fsync(aiori_fd_t *fd, aiori_mod_opt_t * param)
  */
 static void NCMPI_Close(aiori_fd_t *fd, aiori_mod_opt_t * param)
 {
+        ncmpi_options_t * o = (ncmpi_options_t*) param;
+
+        if (o->nonblocking > 0)
+                NCMPI_xfer_flush(fd, o);
+        free(o->pending);
+        free(o->pending_ids);
+        free(o->completed);
+        o->pending = NULL;
+        o->pending_ids = NULL;
+        o->completed = NULL;
+        o->completed_count = 0;
+        o->completed_size = 0;
         NCMPI_CHECK(ncmpi_close(*(int *)fd), "cannot close file");
         free(fd);
 }
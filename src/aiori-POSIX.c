@@ -16,21 +16,25 @@
 #  include "config.h"
 #endif
 
+#ifdef __linux__
+#  define _GNU_SOURCE             /* O_DIRECT, pwritev2() and RWF_* */
+#endif                          /* __linux__ */
+
 #include <stdio.h>
 #include <stdlib.h>
 
 #ifdef __linux__
-#  include <sys/ioctl.h>          /* necessary for: */
-#  define __USE_GNU               /* O_DIRECT and */
-#  include <fcntl.h>              /* IO operations */
-#  undef __USE_GNU
+#  include <sys/ioctl.h>
 #endif                          /* __linux__ */
 
 #include <errno.h>
 #include <unistd.h>
 #include <fcntl.h>              /* IO operations */
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <limits.h>
 #include <assert.h>
+#include <pthread.h>
 
 #ifdef HAVE_GPFS_H
 #  include <gpfs.h>
@@ -60,6 +64,8 @@ typedef long long loff_t;
 
 typedef struct {
   int fd;
+  long long transfers;  /* number of IOR transfers */
+  long long syscalls;   /* number of data system calls issued for them */
 #ifdef HAVE_GPU_DIRECT
   CUfileHandle_t cf_handle;
 #endif
@@ -78,6 +84,10 @@ typedef struct {
 #  define O_BINARY 0
 #endif
 
+#ifndef   O_PATH                /* Linux only, directories */
+#  define O_PATH 0                /* are opened for reading */
+#endif
+
 #ifdef HAVE_GPU_DIRECT
 static const char* cuFileGetErrorString(CUfileError_t status){
   if(IS_CUDA_ERR(status)){
@@ -99,11 +109,17 @@ static void init_cufile(posix_fd * pfd){
 #endif
 
 /**************************** P R O T O T Y P E S *****************************/
-static void POSIX_Initialize(aiori_mod_opt_t * options);
-static void POSIX_Finalize(aiori_mod_opt_t * options);
-
 static IOR_offset_t POSIX_Xfer(int, aiori_fd_t *, IOR_size_t *,
                                IOR_offset_t, IOR_offset_t, aiori_mod_opt_t *);
+static int POSIX_xfer_submit(aiori_fd_t *, aiori_xfer_req_t *, aiori_mod_opt_t *);
+static int POSIX_xfer_poll(aiori_fd_t *, aiori_xfer_req_t **, int, aiori_mod_opt_t *);
+static int POSIX_xfer_wait(aiori_fd_t *, aiori_xfer_req_t **, int, int, aiori_mod_opt_t *);
+static int POSIX_xfer_depth(aiori_mod_opt_t *);
+static void POSIX_xfer_counts(aiori_mod_opt_t *, long long *);
+static int POSIX_Stat(const char *, struct stat *, aiori_mod_opt_t *);
+static int POSIX_Access(const char *, int, aiori_mod_opt_t *);
+static int POSIX_Mkdir(const char *, mode_t, aiori_mod_opt_t *);
+static int POSIX_Rmdir(const char *, aiori_mod_opt_t *);
 
 option_help * POSIX_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt_t * init_values){
   posix_options_t * o = malloc(sizeof(posix_options_t));
@@ -128,6 +144,12 @@ option_help * POSIX_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_o
   option_help h [] = {
     {0, "posix.odirect", "Direct I/O Mode", OPTION_FLAG, 'd', & o->direct_io},
     {0, "posix.rangelocks", "Use range locks (read locks for read ops)", OPTION_FLAG, 'd', & o->range_locks},
+    {0, "posix.vectored", "Issue up to N consecutive transfers with a single pwritev()/preadv(), needs a queue depth of at least N", OPTION_OPTIONAL_ARGUMENT, 'd', & o->vectored},
+    {0, "posix.dirfd-cache", "Keep up to N parent directories open per thread and access files relative to them with openat()/fstatat()/unlinkat()/mkdirat()", OPTION_OPTIONAL_ARGUMENT, 'd', & o->dirfd_cache},
+#ifdef HAVE_PWRITEV2
+    {0, "posix.hipri", "Use pwritev2()/preadv2() with RWF_HIPRI to poll for completion, requires posix.odirect", OPTION_FLAG, 'd', & o->hipri},
+    {0, "posix.nowait", "Use pwritev2()/preadv2() with RWF_NOWAIT, transfers that would block are reissued without it", OPTION_FLAG, 'd', & o->nowait},
+#endif
 #ifdef HAVE_BEEGFS_BEEGFS_H
     {0, "posix.beegfs.NumTargets", "", OPTION_OPTIONAL_ARGUMENT, 'd', & o->beegfs_numTargets},
     {0, "posix.beegfs.ChunkSize", "", OPTION_OPTIONAL_ARGUMENT, 'd', & o->beegfs_chunkSize},
@@ -176,6 +198,11 @@ ior_aiori_t posix_aiori = {
         .mknod = POSIX_Mknod,
         .open = POSIX_Open,
         .xfer = POSIX_Xfer,
+        .xfer_submit = POSIX_xfer_submit,
+        .xfer_poll = POSIX_xfer_poll,
+        .xfer_wait = POSIX_xfer_wait,
+        .xfer_depth = POSIX_xfer_depth,
+        .xfer_counts = POSIX_xfer_counts,
         .close = POSIX_Close,
         .remove = POSIX_Delete,
         .xfer_hints = POSIX_xfer_hints,
@@ -183,13 +210,14 @@ ior_aiori_t posix_aiori = {
         .fsync = POSIX_Fsync,
         .get_file_size = POSIX_GetFileSize,
         .statfs = aiori_posix_statfs,
-        .mkdir = aiori_posix_mkdir,
-        .rmdir = aiori_posix_rmdir,
+        .mkdir = POSIX_Mkdir,
+        .rmdir = POSIX_Rmdir,
         .rename = POSIX_Rename,
-        .access = aiori_posix_access,
-        .stat = aiori_posix_stat,
+        .access = POSIX_Access,
+        .stat = POSIX_Stat,
         .get_options = POSIX_options,
         .enable_mdtest = true,
+        .thread_safe = true,
         .sync = POSIX_Sync,
         .check_params = POSIX_check_params
 };
@@ -225,6 +253,9 @@ int POSIX_check_params(aiori_mod_opt_t * param){
           o->lustre_set_pool = 0;
 #endif
   }
+  if(o->dirfd_cache < 0){
+    ERR("posix.dirfd-cache must not be negative");
+  }
   if(o->gpuDirect && ! o->direct_io){
     ERR("GPUDirect required direct I/O to be used!");
   }
@@ -233,6 +264,15 @@ int POSIX_check_params(aiori_mod_opt_t * param){
     ERR("GPUDirect support is not compiled");
   }
 #endif
+  if(o->vectored < 0 || o->vectored > IOV_MAX){
+    ERRF("posix.vectored must be between 0 and %d", IOV_MAX);
+  }
+  if(o->vectored > 1 && o->gpuDirect){
+    ERR("posix.vectored cannot be used with GPUDirect");
+  }
+  if((o->hipri || o->nowait) && o->gpuDirect){
+    ERR("posix.hipri and posix.nowait cannot be used with GPUDirect");
+  }
   return 0;
 }
 
@@ -498,6 +538,229 @@ void lustre_disable_file_locks(const int fd) {
 }
 #endif /* HAVE_LUSTRE_USER */
 
+/*
+ * Directory descriptors for posix.dirfd-cache: every thread keeps the most
+ * recently used parent directories open and resolves the last component of
+ * a path relative to them with the *at() calls.  A cached directory may be
+ * removed and recreated by another task, a lookup failing with ENOENT is
+ * therefore retried once with a freshly opened parent.
+ */
+typedef struct {
+  char * path;          /* parent directory without trailing '/' */
+  size_t len;
+  uint64_t hash;
+  int fd;               /* O_PATH descriptor of the directory */
+  uint64_t used;        /* LRU clock at the last use */
+} posix_dir_t;
+
+typedef struct {
+  posix_dir_t * dirs;
+  int count;
+  int last;             /* entry of the previous lookup */
+  uint64_t clock;
+} posix_dir_cache_t;
+
+static int dir_cache_size = 0;  /* 0 if the cache is disabled */
+static pthread_key_t dir_cache_key;
+
+static void posix_dir_cache_free(void * data)
+{
+        posix_dir_cache_t * c = (posix_dir_cache_t*) data;
+        for (int i = 0; i < c->count; i++) {
+                close(c->dirs[i].fd);
+                free(c->dirs[i].path);
+        }
+        free(c->dirs);
+        free(c);
+}
+
+static posix_dir_cache_t * posix_dir_cache(void)
+{
+        posix_dir_cache_t * c = pthread_getspecific(dir_cache_key);
+        if (c != NULL)
+                return c;
+        c = safeMalloc(sizeof(posix_dir_cache_t));
+        memset(c, 0, sizeof(posix_dir_cache_t));
+        c->dirs = safeMalloc(sizeof(posix_dir_t) * dir_cache_size);
+        pthread_setspecific(dir_cache_key, c);
+        return c;
+}
+
+static void posix_dir_cache_remove(posix_dir_cache_t * c, int i)
+{
+        close(c->dirs[i].fd);
+        free(c->dirs[i].path);
+        c->dirs[i] = c->dirs[--c->count];
+        c->last = 0;
+}
+
+/*
+ * Returns the descriptor of the parent directory of path and the name
+ * relative to it in name, which may point into buf.  If the cache is
+ * disabled or the parent cannot be opened, AT_FDCWD and the path are returned.
+ */
+static int posix_dir_lookup(const char * path, char * buf, const char ** name)
+{
+        *name = path;
+        if (dir_cache_size == 0)
+                return AT_FDCWD;
+
+        size_t len = strlen(path);
+        while (len > 1 && path[len - 1] == '/')
+                len--;
+        if (len >= PATH_MAX)
+                return AT_FDCWD;
+        size_t slash = len;
+        while (slash > 0 && path[slash - 1] != '/')
+                slash--;
+        if (slash == 0 || slash == len)
+                return AT_FDCWD;
+        size_t plen = slash > 1 ? slash - 1 : 1;
+
+        /* FNV-1a */
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < plen; i++)
+                hash = (hash ^ (unsigned char) path[i]) * 1099511628211ULL;
+
+        posix_dir_cache_t * c = posix_dir_cache();
+        posix_dir_t * d = NULL;
+        if (c->last < c->count && c->dirs[c->last].hash == hash)
+                d = & c->dirs[c->last];
+        for (int i = 0; d == NULL && i < c->count; i++) {
+                if (c->dirs[i].hash == hash) {
+                        d = & c->dirs[i];
+                        c->last = i;
+                }
+        }
+        if (d != NULL && (d->len != plen || memcmp(d->path, path, plen) != 0))
+                d = NULL;
+
+        if (d == NULL) {
+                memcpy(buf, path, plen);
+                buf[plen] = 0;
+                int fd = open(buf, O_PATH | O_DIRECTORY | O_CLOEXEC);
+                if (fd < 0)
+                        return AT_FDCWD;
+                if (c->count == dir_cache_size) {
+                        int lru = 0;
+                        for (int i = 1; i < c->count; i++) {
+                                if (c->dirs[i].used < c->dirs[lru].used)
+                                        lru = i;
+                        }
+                        posix_dir_cache_remove(c, lru);
+                }
+                c->last = c->count++;
+                d = & c->dirs[c->last];
+                d->path = strdup(buf);
+                d->len = plen;
+                d->hash = hash;
+                d->fd = fd;
+        }
+        d->used = ++c->clock;
+
+        memcpy(buf, path + slash, len - slash);
+        buf[len - slash] = 0;
+        *name = buf;
+        return d->fd;
+}
+
+/* forgets the directory fd, or if fd is -1, path and the directories below it */
+static void posix_dir_forget(int fd, const char * path)
+{
+        if (dir_cache_size == 0)
+                return;
+        posix_dir_cache_t * c = posix_dir_cache();
+        size_t len = path ? strlen(path) : 0;
+        while (len > 1 && path[len - 1] == '/')
+                len--;
+        for (int i = c->count - 1; i >= 0; i--) {
+                posix_dir_t * d = & c->dirs[i];
+                if (fd >= 0 ? d->fd == fd :
+                    (d->len >= len && memcmp(d->path, path, len) == 0
+                     && (d->len == len || d->path[len] == '/')))
+                        posix_dir_cache_remove(c, i);
+        }
+}
+
+typedef struct {
+  int flags;
+  mode_t mode;
+  struct stat * buf;
+} posix_at_args_t;
+
+typedef int (*posix_at_fn)(int dirfd, const char * name, posix_at_args_t * a);
+
+static int posix_at_open(int dirfd, const char * name, posix_at_args_t * a)
+{
+        return openat(dirfd, name, a->flags, a->mode);
+}
+
+static int posix_at_stat(int dirfd, const char * name, posix_at_args_t * a)
+{
+        return fstatat(dirfd, name, a->buf, 0);
+}
+
+static int posix_at_access(int dirfd, const char * name, posix_at_args_t * a)
+{
+        return faccessat(dirfd, name, a->mode, 0);
+}
+
+static int posix_at_mkdir(int dirfd, const char * name, posix_at_args_t * a)
+{
+        return mkdirat(dirfd, name, a->mode);
+}
+
+static int posix_at_unlink(int dirfd, const char * name, posix_at_args_t * a)
+{
+        return unlinkat(dirfd, name, a->flags);
+}
+
+/* runs the operation on path, relative to the cached parent if enabled */
+static int posix_at(const char * path, posix_at_fn fn, posix_at_args_t * a)
+{
+        char buf[PATH_MAX];
+        const char * name;
+        int dirfd = posix_dir_lookup(path, buf, & name);
+        int ret = fn(dirfd, name, a);
+        if (ret < 0 && errno == ENOENT && dirfd != AT_FDCWD) {
+                posix_dir_forget(dirfd, NULL);
+                dirfd = posix_dir_lookup(path, buf, & name);
+                ret = fn(dirfd, name, a);
+        }
+        return ret;
+}
+
+static int posix_open(const char * path, int flags, mode_t mode)
+{
+        posix_at_args_t a = {.flags = flags, .mode = mode};
+        return posix_at(path, posix_at_open, & a);
+}
+
+static int POSIX_Stat(const char * path, struct stat * buf, aiori_mod_opt_t * param)
+{
+        posix_at_args_t a = {.buf = buf};
+        return posix_at(path, posix_at_stat, & a);
+}
+
+static int POSIX_Access(const char * path, int mode, aiori_mod_opt_t * param)
+{
+        posix_at_args_t a = {.mode = mode};
+        return posix_at(path, posix_at_access, & a);
+}
+
+static int POSIX_Mkdir(const char * path, mode_t mode, aiori_mod_opt_t * param)
+{
+        posix_at_args_t a = {.mode = mode};
+        return posix_at(path, posix_at_mkdir, & a);
+}
+
+static int POSIX_Rmdir(const char * path, aiori_mod_opt_t * param)
+{
+        posix_at_args_t a = {.flags = AT_REMOVEDIR};
+        posix_dir_forget(-1, path);
+        return posix_at(path, posix_at_unlink, & a);
+}
+
 /*
  * Create and open a file through the POSIX interface.
  */
@@ -613,7 +876,7 @@ aiori_fd_t *POSIX_Create(char *testFileName, int flags, aiori_mod_opt_t * param)
                  }
 #endif /* HAVE_BEEGFS_BEEGFS_H */
 
-                pfd->fd = open64(testFileName, fd_oflag, mode);
+                pfd->fd = posix_open(testFileName, fd_oflag, mode);
                 if (pfd->fd < 0){
                         ERRF("open64(\"%s\", %d, %#o) failed. Error: %s",
                                 testFileName, fd_oflag, mode, strerror(errno));
@@ -685,7 +948,7 @@ aiori_fd_t *POSIX_Open(char *testFileName, int flags, aiori_mod_opt_t * param)
         if(hints->dryRun)
           return (aiori_fd_t*) 0;
 
-        pfd->fd = open64(testFileName, fd_oflag);
+        pfd->fd = posix_open(testFileName, fd_oflag, 0);
         if (pfd->fd < 0)
                 ERRF("open64(\"%s\", %d) failed: %s", testFileName, fd_oflag, strerror(errno));
 
@@ -714,15 +977,61 @@ aiori_fd_t *POSIX_Open(char *testFileName, int flags, aiori_mod_opt_t * param)
         return (aiori_fd_t*) pfd;
 }
 
+/* the system call POSIX_Rw() issues */
+static const char * POSIX_RwName(int access, int iovcnt, posix_options_t * o)
+{
+#ifdef HAVE_PWRITEV2
+        if (o->hipri || o->nowait)
+                return access == WRITE ? "pwritev2" : "preadv2";
+#endif
+        if (iovcnt == 1)
+                return access == WRITE ? "pwrite" : "pread";
+        return access == WRITE ? "pwritev" : "preadv";
+}
+
+/* a single positional read or write of the vector, counted as one system call */
+static ssize_t POSIX_Rw(int access, posix_fd * pfd, struct iovec * iov, int iovcnt, off_t offset, posix_options_t * o)
+{
+        ssize_t rc;
+        __atomic_fetch_add(& pfd->syscalls, 1, __ATOMIC_RELAXED);
+#ifdef HAVE_PWRITEV2
+        int flags = (o->hipri ? RWF_HIPRI : 0) | (o->nowait ? RWF_NOWAIT : 0);
+        if (flags) {
+                if (access == WRITE)
+                        rc = pwritev2(pfd->fd, iov, iovcnt, offset, flags);
+                else
+                        rc = preadv2(pfd->fd, iov, iovcnt, offset, flags);
+                if (rc >= 0 || (errno != EAGAIN && errno != EOPNOTSUPP) || ! o->nowait)
+                        return rc;
+                /* the transfer would block or the file system does not support
+                   RWF_NOWAIT, issue it again without it */
+                __atomic_fetch_add(& pfd->syscalls, 1, __ATOMIC_RELAXED);
+                flags &= ~RWF_NOWAIT;
+                if (access == WRITE)
+                        return pwritev2(pfd->fd, iov, iovcnt, offset, flags);
+                return preadv2(pfd->fd, iov, iovcnt, offset, flags);
+        }
+#endif
+        if (iovcnt == 1) {
+                if (access == WRITE)
+                        return pwrite(pfd->fd, iov->iov_base, iov->iov_len, offset);
+                return pread(pfd->fd, iov->iov_base, iov->iov_len, offset);
+        }
+        if (access == WRITE)
+                return pwritev(pfd->fd, iov, iovcnt, offset);
+        return preadv(pfd->fd, iov, iovcnt, offset);
+}
+
 /*
  * Write or read access to file using the POSIX interface.
+ * The iovcnt buffers of iov with length bytes in total are accessed at consecutive offsets
+ * starting at offset; iov is modified in case of a partial transfer.
  */
-static IOR_offset_t POSIX_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer,
+static IOR_offset_t POSIX_Xferv(int access, aiori_fd_t *file, struct iovec * iov, int iovcnt,
                                IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * param)
 {
         int xferRetries = 0;
         long long remaining = (long long)length;
-        char *ptr = (char *)buffer;
         long long rc;
         int fd;
         posix_options_t * o = (posix_options_t*) param;
@@ -732,6 +1041,7 @@ static IOR_offset_t POSIX_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer
 
         posix_fd * pfd = (posix_fd *) file;
         fd = pfd->fd;
+        __atomic_fetch_add(& pfd->transfers, iovcnt, __ATOMIC_RELAXED);
 
 #ifdef HAVE_GPFS_FCNTL_H
         if (o->gpfs_hint_access) {
@@ -740,9 +1050,7 @@ static IOR_offset_t POSIX_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer
 #endif
 
 
-        /* seek to offset */
-        if (lseek64(fd, offset, SEEK_SET) == -1)
-                ERRF("lseek64(%d, %lld, SEEK_SET) failed", fd, offset);
+        /* positional I/O keeps the file offset untouched, concurrent transfers on fd are safe */
         off_t mem_offset = 0;
 
         if(o->range_locks){
@@ -766,15 +1074,15 @@ static IOR_offset_t POSIX_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer
                         }
 #ifdef HAVE_GPU_DIRECT
                         if(o->gpuDirect){
-                          rc = cuFileWrite(pfd->cf_handle, ptr, remaining, offset + mem_offset, mem_offset);
+                          rc = cuFileWrite(pfd->cf_handle, iov->iov_base, remaining, offset + mem_offset, mem_offset);
                         }else{
 #endif
-                          rc = write(fd, ptr, remaining);
+                          rc = POSIX_Rw(access, pfd, iov, iovcnt, offset + mem_offset, o);
 #ifdef HAVE_GPU_DIRECT
                         }
 #endif
                         if (rc < 0){
-                          WARNF("write(%d, %p, %lld) failed %s", fd, (void*)ptr, remaining, strerror(errno));
+                          WARNF("%s(%d, %p, %lld, %lld) failed %s", POSIX_RwName(access, iovcnt, o), fd, iov->iov_base, remaining, (long long) (offset + mem_offset), strerror(errno));
                         }
                         if (hints->fsyncPerWrite == TRUE){
                           POSIX_Fsync((aiori_fd_t*) &fd, param);
@@ -787,27 +1095,27 @@ static IOR_offset_t POSIX_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer
                         }
 #ifdef HAVE_GPU_DIRECT
                         if(o->gpuDirect){
-                          rc = cuFileRead(pfd->cf_handle, ptr, remaining, offset + mem_offset, mem_offset);
+                          rc = cuFileRead(pfd->cf_handle, iov->iov_base, remaining, offset + mem_offset, mem_offset);
                         }else{
 #endif
-                          rc = read(fd, ptr, remaining);
+                          rc = POSIX_Rw(access, pfd, iov, iovcnt, offset + mem_offset, o);
 #ifdef HAVE_GPU_DIRECT
                         }
 #endif
                         if (rc == 0){
-                          WARNF("read(%d, %p, %lld) returned EOF prematurely", fd, (void*)ptr, remaining);
+                          WARNF("%s(%d, %p, %lld, %lld) returned EOF prematurely", POSIX_RwName(access, iovcnt, o), fd, iov->iov_base, remaining, (long long) (offset + mem_offset));
                           return length - remaining;
                         }
                                 
                         if (rc < 0){
-                          WARNF("read(%d, %p, %lld) failed %s", fd, (void*)ptr, remaining, strerror(errno));
+                          WARNF("%s(%d, %p, %lld, %lld) failed %s", POSIX_RwName(access, iovcnt, o), fd, iov->iov_base, remaining, (long long) (offset + mem_offset), strerror(errno));
                           return length - remaining;
                         }
                 }
                 if (rc < remaining) {
-                        WARNF("task %d, partial %s, %lld of %lld bytes at offset %lld\n",
+                        WARNF("task %d, partial %s(), %lld of %lld bytes at offset %lld\n",
                                 rank,
-                                access == WRITE ? "write()" : "read()",
+                                POSIX_RwName(access, iovcnt, o),
                                 rc, remaining,
                                 offset + length - remaining);
                         if (xferRetries > MAX_RETRY || hints->singleXferAttempt){
@@ -818,9 +1126,20 @@ static IOR_offset_t POSIX_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer
                 assert(rc >= 0);
                 assert(rc <= remaining);
                 remaining -= rc;
-                ptr += rc;
                 mem_offset += rc;
                 xferRetries++;
+                /* skip the transferred part of the vector */
+                while (rc > 0 && iovcnt > 0) {
+                        if ((size_t) rc >= iov->iov_len) {
+                                rc -= iov->iov_len;
+                                iov++;
+                                iovcnt--;
+                        } else {
+                                iov->iov_base = (char *) iov->iov_base + rc;
+                                iov->iov_len -= rc;
+                                rc = 0;
+                        }
+                }
         }
         if(o->range_locks){
           struct flock lck = {
@@ -841,6 +1160,101 @@ static IOR_offset_t POSIX_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer
         return (length);
 }
 
+static IOR_offset_t POSIX_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer,
+                               IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * param)
+{
+        struct iovec iov = {.iov_base = buffer, .iov_len = length};
+        return POSIX_Xferv(access, file, & iov, 1, length, offset, param);
+}
+
+/*
+ * Asynchronous interface: with posix.vectored=N, consecutive transfers of the same
+ * kind are collected and issued with one system call once N are pending, the next
+ * one is not consecutive, or IOR waits for a completion.
+ * Otherwise, transfers are performed upon submission.
+ */
+static __thread aiori_fd_t * pending_fd = NULL;
+static __thread aiori_xfer_req_t ** pending_reqs = NULL;
+static __thread int pending_count = 0;
+static __thread aiori_xfer_req_t ** completed_reqs = NULL;
+static __thread int completed_count = 0;
+static __thread int completed_size = 0;
+
+static void POSIX_xfer_complete(aiori_xfer_req_t * req){
+  if(completed_count == completed_size){
+    completed_size = completed_size == 0 ? 16 : completed_size * 2;
+    completed_reqs = realloc(completed_reqs, sizeof(aiori_xfer_req_t *) * completed_size);
+    if(completed_reqs == NULL){
+      ERR("POSIX out of memory");
+    }
+  }
+  completed_reqs[completed_count++] = req;
+}
+
+static void POSIX_xfer_flush(aiori_mod_opt_t * param){
+  if(pending_count == 0){
+    return;
+  }
+  struct iovec iov[pending_count];
+  IOR_offset_t length = 0;
+  for(int i = 0; i < pending_count; i++){
+    iov[i].iov_base = pending_reqs[i]->buffer;
+    iov[i].iov_len = pending_reqs[i]->length;
+    length += pending_reqs[i]->length;
+  }
+  IOR_offset_t done = POSIX_Xferv(pending_reqs[0]->access, pending_fd, iov, pending_count, length, pending_reqs[0]->offset, param);
+  for(int i = 0; i < pending_count; i++){
+    aiori_xfer_req_t * req = pending_reqs[i];
+    req->transferred = done < req->length ? done : req->length;
+    done -= req->transferred;
+    POSIX_xfer_complete(req);
+  }
+  pending_count = 0;
+}
+
+static int POSIX_xfer_submit(aiori_fd_t *file, aiori_xfer_req_t * req, aiori_mod_opt_t * param){
+  posix_options_t * o = (posix_options_t*) param;
+  if(o->vectored <= 1){
+    req->transferred = POSIX_Xfer(req->access, file, req->buffer, req->length, req->offset, param);
+    POSIX_xfer_complete(req);
+    return 0;
+  }
+  if(pending_count > 0){
+    aiori_xfer_req_t * last = pending_reqs[pending_count - 1];
+    if(pending_fd != file || last->access != req->access || last->offset + last->length != req->offset){
+      POSIX_xfer_flush(param);
+    }
+  }
+  if(pending_reqs == NULL){
+    pending_reqs = safeMalloc(sizeof(aiori_xfer_req_t *) * IOV_MAX);
+  }
+  pending_fd = file;
+  pending_reqs[pending_count++] = req;
+  if(pending_count >= o->vectored){
+    POSIX_xfer_flush(param);
+  }
+  return 0;
+}
+
+static int POSIX_xfer_poll(aiori_fd_t *file, aiori_xfer_req_t ** completed, int max, aiori_mod_opt_t * param){
+  int count = completed_count < max ? completed_count : max;
+  completed_count -= count;
+  memcpy(completed, completed_reqs + completed_count, sizeof(aiori_xfer_req_t *) * count);
+  return count;
+}
+
+static int POSIX_xfer_wait(aiori_fd_t *file, aiori_xfer_req_t ** completed, int min, int max, aiori_mod_opt_t * param){
+  if(completed_count < min){
+    POSIX_xfer_flush(param);
+  }
+  return POSIX_xfer_poll(file, completed, max, param);
+}
+
+static int POSIX_xfer_depth(aiori_mod_opt_t * param){
+  posix_options_t * o = (posix_options_t*) param;
+  return o->vectored > 1 ? o->vectored : 1;
+}
+
 void POSIX_Fsync(aiori_fd_t *afd, aiori_mod_opt_t * param)
 {
     int fd = ((posix_fd*) afd)->fd;
@@ -858,6 +1272,16 @@ void POSIX_Sync(aiori_mod_opt_t * param)
 }
 
 
+/* transfers and system calls of the closed files, see POSIX_xfer_counts() */
+static long long posix_transfers;
+static long long posix_syscalls;
+
+static void POSIX_xfer_counts(aiori_mod_opt_t * param, long long * counts)
+{
+        counts[0] = __atomic_exchange_n(& posix_transfers, 0, __ATOMIC_RELAXED);
+        counts[1] = __atomic_exchange_n(& posix_syscalls, 0, __ATOMIC_RELAXED);
+}
+
 /*
  * Close a file through the POSIX interface.
  */
@@ -866,7 +1290,13 @@ void POSIX_Close(aiori_fd_t *afd, aiori_mod_opt_t * param)
         if(hints->dryRun)
           return;
         posix_options_t * o = (posix_options_t*) param;
-        int fd = ((posix_fd*) afd)->fd;
+        posix_fd * pfd = (posix_fd*) afd;
+        int fd = pfd->fd;
+        if (pfd->syscalls > 0 && verbose >= VERBOSE_2){
+                INFOF("task %d: %lld transfers with %lld system calls\n", rank, pfd->transfers, pfd->syscalls);
+        }
+        __atomic_fetch_add(& posix_transfers, pfd->transfers, __ATOMIC_RELAXED);
+        __atomic_fetch_add(& posix_syscalls, pfd->syscalls, __ATOMIC_RELAXED);
 #ifdef HAVE_GPU_DIRECT
         if(o->gpuDirect){
           cuFileHandleDeregister(((posix_fd*) afd)->cf_handle);
@@ -885,7 +1315,8 @@ void POSIX_Delete(char *testFileName, aiori_mod_opt_t * param)
 {
         if(hints->dryRun)
           return;
-        if (unlink(testFileName) != 0){
+        posix_at_args_t a = {.flags = 0};
+        if (posix_at(testFileName, posix_at_unlink, & a) != 0){
                 WARNF("[RANK %03d]: unlink() of file \"%s\" failed", rank, testFileName);
         }
 }
@@ -894,6 +1325,7 @@ int POSIX_Rename(const char * oldfile, const char * newfile, aiori_mod_opt_t * m
   if(hints->dryRun)
     return 0;
 
+  posix_dir_forget(-1, oldfile);
   if(rename(oldfile, newfile) != 0){
     WARNF("[RANK %03d]: rename() of file \"%s\" to  \"%s\" failed", rank, oldfile, newfile);
     return -1;
@@ -920,12 +1352,27 @@ IOR_offset_t POSIX_GetFileSize(aiori_mod_opt_t * test, char *testFileName)
 }
 
 void POSIX_Initialize(aiori_mod_opt_t * options){
+  posix_options_t * o = (posix_options_t*) options;
+  if(o->dirfd_cache > 0){
+    if(pthread_key_create(& dir_cache_key, posix_dir_cache_free) != 0){
+      ERR("Couldn't create the directory cache key");
+    }
+    dir_cache_size = o->dirfd_cache;
+  }
 #ifdef HAVE_GPU_DIRECT
   CUfileError_t err = cuFileDriverOpen();
 #endif
 }
 
 void POSIX_Finalize(aiori_mod_opt_t * options){
+  if(dir_cache_size > 0){
+    posix_dir_cache_t * c = pthread_getspecific(dir_cache_key);
+    if(c != NULL){
+      posix_dir_cache_free(c);
+    }
+    pthread_key_delete(dir_cache_key);
+    dir_cache_size = 0;
+  }
 #ifdef HAVE_GPU_DIRECT
   CUfileError_t err = cuFileDriverClose();
 #endif
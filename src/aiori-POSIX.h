@@ -44,6 +44,10 @@ typedef struct{
   int beegfs_chunkSize;            /* srtipe pattern for new files */
   int gpuDirect;
   int range_locks;                 /* use POSIX range locks for writes */
+  int vectored;                    /* max. number of consecutive transfers per system call */
+  int hipri;                       /* RWF_HIPRI for pwritev2()/preadv2() */
+  int nowait;                      /* RWF_NOWAIT for pwritev2()/preadv2() */
+  int dirfd_cache;                 /* number of parent directories kept open per thread */
 } posix_options_t;
 
 void POSIX_Sync(aiori_mod_opt_t * param);
@@ -59,6 +63,8 @@ int POSIX_Rename(const char *oldfile, const char *newfile, aiori_mod_opt_t * mod
 void POSIX_Close(aiori_fd_t *fd, aiori_mod_opt_t * module_options);
 option_help * POSIX_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt_t * init_values);
 void POSIX_xfer_hints(aiori_xfer_hint_t * params);
+void POSIX_Initialize(aiori_mod_opt_t * options);
+void POSIX_Finalize(aiori_mod_opt_t * options);
 
 
 #endif
@@ -8,6 +8,7 @@
 #endif
 
 #include <libaio.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -30,15 +31,30 @@ typedef struct{
   aiori_mod_opt_t * p; // posix options
   int max_pending;
   int granularity; // how frequent to submit, submit ever granularity elements
+  int poll; // busy poll for completions instead of blocking in io_getevents()
 
   // runtime data
-  io_context_t ioctx; // one context per fs
+  pthread_key_t queue_key; // every thread submits to its own aio_queue_t
+} aio_options_t;
+
+/* the submission and completion state of one thread */
+typedef struct{
+  io_context_t ioctx;
   struct iocb ** iocbs;
   int iocbs_pos; // how many are pending in iocbs
 
+  struct iocb * iocb_pool; // max_pending preallocated control blocks
+  struct iocb ** iocb_free; // stack of unused control blocks
+  int iocb_free_count;
+  struct io_event * events; // max_pending events filled by io_getevents()
+
   int in_flight; // total pending ops
   IOR_offset_t pending_bytes; // track pending IO volume for error checking
-} aio_options_t;
+
+  aiori_xfer_req_t ** done; // completed requests of xfer_submit() not yet returned to IOR
+  int done_count;
+  int done_size;
+} aio_queue_t;
 
 option_help * aio_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt_t * init_values){
   aio_options_t * o = malloc(sizeof(aio_options_t));
@@ -56,6 +72,7 @@ option_help * aio_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt
   option_help h [] = {
     {0, "aio.max-pending", "Max number of pending ops", OPTION_OPTIONAL_ARGUMENT, 'd', & o->max_pending},
     {0, "aio.granularity", "How frequent to submit pending IOs, submit every *granularity* elements", OPTION_OPTIONAL_ARGUMENT, 'd', & o->granularity},
+    {0, "aio.poll", "Busy poll for completions instead of blocking", OPTION_FLAG, 'd', & o->poll},
     LAST_OPTION
   };
   option_help * help = option_merge(h, p_help);
@@ -79,20 +96,60 @@ static void aio_xfer_hints(aiori_xfer_hint_t * params){
   POSIX_xfer_hints(params);
 }
 
-static void aio_initialize(aiori_mod_opt_t * param){
-  aio_options_t * o = (aio_options_t*) param;
-  if(io_setup(o->max_pending, & o->ioctx) != 0){
+static void queue_free(void * data){
+  aio_queue_t * q = (aio_queue_t*) data;
+  io_destroy(q->ioctx);
+  free(q->iocbs);
+  free(q->iocb_pool);
+  free(q->iocb_free);
+  free(q->events);
+  free(q->done);
+  free(q);
+}
+
+/* returns the queue of the calling thread, it is released once the thread terminates */
+static aio_queue_t * get_queue(aio_options_t * o){
+  aio_queue_t * q = pthread_getspecific(o->queue_key);
+  if(q != NULL){
+    return q;
+  }
+  q = safeMalloc(sizeof(aio_queue_t));
+  memset(q, 0, sizeof(aio_queue_t));
+  if(io_setup(o->max_pending, & q->ioctx) != 0){
     ERRF("Couldn't initialize io context %s", strerror(errno));
   }
 
-  o->iocbs = malloc(sizeof(struct iocb *) * o->granularity);
-  o->iocbs_pos = 0;
-  o->in_flight = 0;
+  q->iocbs = safeMalloc(sizeof(struct iocb *) * o->granularity);
+  q->iocb_pool = safeMalloc(sizeof(struct iocb) * o->max_pending);
+  q->iocb_free = safeMalloc(sizeof(struct iocb *) * o->max_pending);
+  for(int i = 0; i < o->max_pending; i++){
+    q->iocb_free[i] = & q->iocb_pool[i];
+  }
+  q->iocb_free_count = o->max_pending;
+  q->events = safeMalloc(sizeof(struct io_event) * o->max_pending);
+  q->done_size = o->max_pending;
+  q->done = safeMalloc(sizeof(aiori_xfer_req_t *) * q->done_size);
+  pthread_setspecific(o->queue_key, q);
+  return q;
+}
+
+static void aio_initialize(aiori_mod_opt_t * param){
+  aio_options_t * o = (aio_options_t*) param;
+  if(pthread_key_create(& o->queue_key, queue_free) != 0){
+    ERR("Couldn't create the AIO queue key");
+  }
+  get_queue(o);
+  POSIX_Initialize(o->p);
 }
 
 static void aio_finalize(aiori_mod_opt_t * param){
   aio_options_t * o = (aio_options_t*) param;
-  io_destroy(o->ioctx);
+  aio_queue_t * q = pthread_getspecific(o->queue_key);
+  if(q != NULL){
+    queue_free(q);
+  }
+  pthread_key_delete(o->queue_key);
+  POSIX_Finalize(o->p);
 }
 
 static int aio_check_params(aiori_mod_opt_t * param){
@@ -122,92 +179,162 @@ static aiori_fd_t *aio_create(char *testFileName, int flags, aiori_mod_opt_t * p
 }
 
 /* called whenever the granularity is met */
-static void submit_pending(aio_options_t * o){
-  if(o->iocbs_pos == 0){
+static void submit_pending(aio_queue_t * q){
+  if(q->iocbs_pos == 0){
     return;
   }
   int res;
-  res = io_submit(o->ioctx, o->iocbs_pos, o->iocbs);
-  //printf("AIO submit %d jobs\n", o->iocbs_pos);
-  if(res != o->iocbs_pos){
+  res = io_submit(q->ioctx, q->iocbs_pos, q->iocbs);
+  //printf("AIO submit %d jobs\n", q->iocbs_pos);
+  if(res != q->iocbs_pos){
     if(errno == EAGAIN){
       ERR("AIO: errno == EAGAIN; this should't happen");
     }
     ERRF("AIO: submitted %d, error: \"%s\" ; this should't happen", res, strerror(errno));
   }
-  o->iocbs_pos = 0;
+  q->iocbs_pos = 0;
+}
+
+static void complete_event(aio_queue_t * q, struct io_event * event){
+  aiori_xfer_req_t * req = (aiori_xfer_req_t*) event->data;
+  if(req != NULL){
+    // issued by aio_xfer_submit(), keep it until IOR polls for it
+    req->transferred = (long) event->res;
+    if(q->done_count == q->done_size){
+      q->done_size *= 2;
+      q->done = realloc(q->done, sizeof(aiori_xfer_req_t *) * q->done_size);
+      if(q->done == NULL){
+        ERR("AIO, cannot allocate completion list");
+      }
+    }
+    q->done[q->done_count++] = req;
+  }else if(event->res == -1){
+    ERR("AIO, error in io_getevents(), IO incomplete!");
+  }else{
+    q->pending_bytes -= event->res;
+  }
+  q->iocb_free[q->iocb_free_count++] = event->obj;
+}
+
+/* wait for at least min events, returns the number of completed ops */
+static int reap_events(aio_options_t * o, aio_queue_t * q, int min, struct timespec * timeout){
+  struct timespec no_wait = {0, 0};
+  int reaped = 0;
+  submit_pending(q);
+  if(q->in_flight == 0){
+    return 0;
+  }
+  if(o->poll){
+    // never block in the kernel, spin until min events arrived
+    timeout = & no_wait;
+  }
+  do{
+    int num_events;
+    num_events = io_getevents(q->ioctx, o->poll ? 0 : min - reaped, q->in_flight, q->events, timeout);
+    if(num_events < 0){
+      ERRF("AIO, error in io_getevents(): %s", strerror(-num_events));
+    }
+    for (int i = 0; i < num_events; i++) {
+      complete_event(q, & q->events[i]);
+    }
+    q->in_flight -= num_events;
+    reaped += num_events;
+  }while(o->poll && reaped < min);
+  return reaped;
 }
 
 /* complete all pending ops */
 static void complete_all(aio_options_t * o){
-  submit_pending(o);
-
-  struct io_event events[o->in_flight];
-  int num_events;
-  num_events = io_getevents(o->ioctx, o->in_flight, o->in_flight, events, NULL);
-  for (int i = 0; i < num_events; i++) {
-    struct io_event event = events[i];
-    if(event.res == -1){
-      ERR("AIO, error in io_getevents(), IO incomplete!");
-    }else{
-      o->pending_bytes -= event.res;
-    }
-    free(event.obj);
+  aio_queue_t * q = get_queue(o);
+  while(q->in_flight > 0){
+    reap_events(o, q, q->in_flight, NULL);
   }
-  if(o->pending_bytes != 0){
-    ERRF("AIO, error in flushing data, pending bytes: %lld", o->pending_bytes);
+  if(q->pending_bytes != 0){
+    ERRF("AIO, error in flushing data, pending bytes: %lld", q->pending_bytes);
   }
-  o->in_flight = 0;
 }
 
 /* called if we must make *some* progress */
-static void process_some(aio_options_t * o){
-  if(o->in_flight == 0){
+static void process_some(aio_options_t * o, aio_queue_t * q){
+  if(q->in_flight == 0){
     return;
   }
-  struct io_event events[o->in_flight];
-  int num_events;
-  int mn = o->in_flight < o->granularity ? o->in_flight : o->granularity;
-  num_events = io_getevents(o->ioctx, mn, o->in_flight, events, NULL);
-  //printf("Completed: %d\n", num_events);
-  for (int i = 0; i < num_events; i++) {
-    struct io_event event = events[i];
-    if(event.res == -1){
-      ERR("AIO, error in io_getevents(), IO incomplete!");
-    }else{
-      o->pending_bytes -= event.res;
-    }
-    free(event.obj);
-  }
-  o->in_flight -= num_events;
+  int mn = q->in_flight < o->granularity ? q->in_flight : o->granularity;
+  reap_events(o, q, mn, NULL);
 }
 
-static IOR_offset_t aio_Xfer(int access, aiori_fd_t *fd, IOR_size_t * buffer,
-                               IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * param){
-  aio_options_t * o = (aio_options_t*) param;
-  aio_fd_t * afd = (aio_fd_t*) fd;
-
-  if(o->in_flight >= o->max_pending){
-    process_some(o);
+/* enqueue a single operation, data is returned with its completion event */
+static void queue_iocb(aio_options_t * o, aio_queue_t * q, aio_fd_t * afd, int access, void * buffer, IOR_offset_t length, IOR_offset_t offset, void * data){
+  if(q->in_flight >= o->max_pending){
+    process_some(o, q);
   }
-  o->pending_bytes += length;
-
-  struct iocb * iocb = malloc(sizeof(struct iocb));
+  struct iocb * iocb = q->iocb_free[--q->iocb_free_count];
   if(access == WRITE){
     io_prep_pwrite(iocb, *(int*)afd->pfd, buffer, length, offset);
   }else{
     io_prep_pread(iocb,  *(int*)afd->pfd, buffer, length, offset);
   }
-  o->iocbs[o->iocbs_pos] = iocb;
-  o->iocbs_pos++;
-  o->in_flight++;
+  iocb->data = data;
+  q->iocbs[q->iocbs_pos] = iocb;
+  q->iocbs_pos++;
+  q->in_flight++;
 
-  if(o->iocbs_pos == o->granularity){
-    submit_pending(o);
+  if(q->iocbs_pos == o->granularity){
+    submit_pending(q);
   }
+}
+
+static IOR_offset_t aio_Xfer(int access, aiori_fd_t *fd, IOR_size_t * buffer,
+                               IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * param){
+  aio_options_t * o = (aio_options_t*) param;
+  aio_queue_t * q = get_queue(o);
+
+  q->pending_bytes += length;
+  queue_iocb(o, q, (aio_fd_t*) fd, access, buffer, length, offset, NULL);
   return length;
 }
 
+static int aio_xfer_submit(aiori_fd_t *fd, aiori_xfer_req_t * req, aiori_mod_opt_t * param){
+  aio_options_t * o = (aio_options_t*) param;
+
+  queue_iocb(o, get_queue(o), (aio_fd_t*) fd, req->access, req->buffer, req->length, req->offset, req);
+  return 0;
+}
+
+static int pop_done(aio_queue_t * q, aiori_xfer_req_t ** completed, int max){
+  int count = q->done_count < max ? q->done_count : max;
+  q->done_count -= count;
+  memcpy(completed, q->done + q->done_count, sizeof(aiori_xfer_req_t *) * count);
+  return count;
+}
+
+static int aio_xfer_poll(aiori_fd_t *fd, aiori_xfer_req_t ** completed, int max, aiori_mod_opt_t * param){
+  aio_options_t * o = (aio_options_t*) param;
+  aio_queue_t * q = get_queue(o);
+  struct timespec no_wait = {0, 0};
+  if(q->done_count < max){
+    reap_events(o, q, 0, & no_wait);
+  }
+  return pop_done(q, completed, max);
+}
+
+static int aio_xfer_wait(aiori_fd_t *fd, aiori_xfer_req_t ** completed, int min, int max, aiori_mod_opt_t * param){
+  aio_options_t * o = (aio_options_t*) param;
+  aio_queue_t * q = get_queue(o);
+  while(q->done_count < min && q->in_flight > 0){
+    // ops issued by aio_Xfer() may complete in between, wait for the missing ones only
+    int mn = min - q->done_count;
+    reap_events(o, q, mn < q->in_flight ? mn : q->in_flight, NULL);
+  }
+  return pop_done(q, completed, max);
+}
+
+/* keep one submission batch in flight */
+static int aio_xfer_depth(aiori_mod_opt_t * param){
+  aio_options_t * o = (aio_options_t*) param;
+  return o->granularity;
+}
+
 static void aio_Close(aiori_fd_t *fd, aiori_mod_opt_t * param){
   aio_options_t * o = (aio_options_t*) param;
   aio_fd_t * afd = (aio_fd_t*) fd;
@@ -241,6 +368,10 @@ ior_aiori_t aio_aiori = {
         .fsync = aio_Fsync,
         .open = aio_Open,
         .xfer = aio_Xfer,
+        .xfer_submit = aio_xfer_submit,
+        .xfer_poll = aio_xfer_poll,
+        .xfer_wait = aio_xfer_wait,
+        .xfer_depth = aio_xfer_depth,
         .close = aio_Close,
         .sync = aio_Sync,
         .check_params = aio_check_params,
@@ -252,5 +383,6 @@ ior_aiori_t aio_aiori = {
         .rmdir = aiori_posix_rmdir,
         .access = aiori_posix_access,
         .stat = aiori_posix_stat,
-        .enable_mdtest = true
+        .enable_mdtest = true,
+        .thread_safe = true
 };
@@ -0,0 +1,689 @@
+/*
+ This backend uses Linux io_uring
+ Requires: liburing-dev (liburing >= 2.2)
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <liburing.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <sys/uio.h>
+#include <assert.h>
+#include <unistd.h>
+
+#include "ior.h"
+#include "aiori.h"
+#include "iordef.h"
+#include "utilities.h"
+
+#include "aiori-POSIX.h"
+
+/************************** O P T I O N S *****************************/
+typedef struct{
+  aiori_mod_opt_t * p; // posix options
+  int entries;         // size of the submission queue
+  int batch;           // submit every *batch* queued requests
+  int sqpoll;          // use a kernel thread to poll the submission queue
+  int sqpoll_idle;     // idle time in ms before the poll thread sleeps
+  int sqpoll_cpu;      // pin the poll thread to this CPU, -1 for no pinning
+  int fixed_files;     // register the file descriptor
+  int fixed_buffers;   // number of transfer buffers to register, 0 to disable
+
+  // runtime data
+  struct io_uring ring; // one ring per process
+  int ring_initialized;
+  int in_flight;        // submitted or queued requests
+  int file_registered;
+  struct io_uring_cqe ** cqes; // completions peeked at once, batch entries
+
+  struct iovec * bufs;  // registered buffers, iov_base == NULL for an empty slot
+  int * bufs_busy;      // requests in flight per registered buffer
+  int bufs_next;        // next slot to consider for replacement
+
+  aiori_xfer_req_t * sync_req; // request issued by uring_Xfer()
+  int sync_done;
+
+  aiori_xfer_req_t ** done; // completed requests of xfer_submit() not yet returned to IOR
+  int done_count;
+  int done_size;
+} uring_options_t;
+
+option_help * uring_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt_t * init_values){
+  uring_options_t * o = malloc(sizeof(uring_options_t));
+
+  if (init_values != NULL){
+    memcpy(o, init_values, sizeof(uring_options_t));
+  }else{
+    memset(o, 0, sizeof(uring_options_t));
+    o->entries = 128;
+    o->batch = 16;
+    o->sqpoll_idle = 1000;
+    o->sqpoll_cpu = -1;
+    o->fixed_files = 1;
+    o->fixed_buffers = 0;
+  }
+  option_help * p_help = POSIX_options((aiori_mod_opt_t**)& o->p, init_values == NULL ? NULL : (aiori_mod_opt_t*) ((uring_options_t*)init_values)->p);
+  *init_backend_options = (aiori_mod_opt_t*) o;
+
+  option_help h [] = {
+    {0, "uring.entries", "Size of the submission queue, limits the number of requests in flight", OPTION_OPTIONAL_ARGUMENT, 'd', & o->entries},
+    {0, "uring.batch", "Submit pending requests every *batch* requests", OPTION_OPTIONAL_ARGUMENT, 'd', & o->batch},
+    {0, "uring.sqpoll", "Use a kernel thread polling the submission queue (SQPOLL)", OPTION_FLAG, 'd', & o->sqpoll},
+    {0, "uring.sqpoll-idle", "Idle time in ms until the SQPOLL thread goes to sleep", OPTION_OPTIONAL_ARGUMENT, 'd', & o->sqpoll_idle},
+    {0, "uring.sqpoll-cpu", "Pin the SQPOLL thread to this CPU, -1 disables pinning", OPTION_OPTIONAL_ARGUMENT, 'd', & o->sqpoll_cpu},
+    {0, "uring.fixed-files", "Register the file descriptor with the ring, 0 disables it", OPTION_OPTIONAL_ARGUMENT, 'd', & o->fixed_files},
+    {0, "uring.fixed-buffers", "Number of transfer buffers to register with the ring, 0 disables it", OPTION_OPTIONAL_ARGUMENT, 'd', & o->fixed_buffers},
+    LAST_OPTION
+  };
+  option_help * help = option_merge(h, p_help);
+  free(p_help);
+  return help;
+}
+
+
+/************************** D E C L A R A T I O N S ***************************/
+
+typedef struct{
+  aiori_fd_t * pfd; // the underlying POSIX fd
+} uring_fd_t;
+
+/***************************** F U N C T I O N S ******************************/
+
+static aiori_xfer_hint_t * hints = NULL;
+
+static void uring_xfer_hints(aiori_xfer_hint_t * params){
+  hints = params;
+  POSIX_xfer_hints(params);
+}
+
+static void uring_initialize(aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  struct io_uring_params params;
+  int ret;
+
+  memset(& params, 0, sizeof(params));
+  if(o->sqpoll){
+    params.flags |= IORING_SETUP_SQPOLL;
+    params.sq_thread_idle = o->sqpoll_idle;
+    if(o->sqpoll_cpu >= 0){
+      params.flags |= IORING_SETUP_SQ_AFF;
+      params.sq_thread_cpu = o->sqpoll_cpu;
+    }
+  }
+  ret = io_uring_queue_init_params(o->entries, & o->ring, & params);
+  if(ret < 0){
+    ERRF("URING: cannot initialize the ring: %s", strerror(-ret));
+  }
+  o->ring_initialized = 1;
+  o->in_flight = 0;
+  o->file_registered = 0;
+  o->cqes = safeMalloc(sizeof(struct io_uring_cqe *) * o->batch);
+
+  if(o->fixed_buffers > 0){
+    ret = io_uring_register_buffers_sparse(& o->ring, o->fixed_buffers);
+    if(ret < 0){
+      ERRF("URING: cannot register %d buffers: %s", o->fixed_buffers, strerror(-ret));
+    }
+    o->bufs = safeMalloc(sizeof(struct iovec) * o->fixed_buffers);
+    o->bufs_busy = safeMalloc(sizeof(int) * o->fixed_buffers);
+    memset(o->bufs, 0, sizeof(struct iovec) * o->fixed_buffers);
+    memset(o->bufs_busy, 0, sizeof(int) * o->fixed_buffers);
+    o->bufs_next = 0;
+  }
+  POSIX_Initialize(o->p);
+}
+
+static void uring_finalize(aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  if(! o->ring_initialized){
+    return;
+  }
+  POSIX_Finalize(o->p);
+  io_uring_queue_exit(& o->ring);
+  o->ring_initialized = 0;
+  free(o->bufs);
+  free(o->bufs_busy);
+  free(o->done);
+  free(o->cqes);
+  o->bufs = NULL;
+  o->bufs_busy = NULL;
+  o->done = NULL;
+  o->cqes = NULL;
+  o->done_size = 0;
+}
+
+static int uring_check_params(aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  POSIX_check_params((aiori_mod_opt_t*) o->p);
+  if(o->entries < 8){
+    ERRF("URING entries = %d < 8", o->entries);
+  }
+  if(o->batch < 1 || o->batch > o->entries){
+    ERRF("URING batch must be between 1 and entries, is %d", o->batch);
+  }
+  if(o->fixed_buffers < 0){
+    ERRF("URING fixed-buffers must be >= 0, is %d", o->fixed_buffers);
+  }
+  return 0;
+}
+
+/*
+ * Drop all buffer registrations, the buffers may be freed and their
+ * addresses reused for different memory once a file is closed.
+ */
+static void clear_buffers(uring_options_t * o){
+  for(int i = 0; i < o->fixed_buffers; i++){
+    if(o->bufs[i].iov_base == NULL){
+      continue;
+    }
+    struct iovec empty = {NULL, 0};
+    uint64_t tag = 0;
+    int ret = io_uring_register_buffers_update_tag(& o->ring, i, & empty, & tag, 1);
+    if(ret < 0){
+      WARNF("URING: cannot unregister buffer %d: %s", i, strerror(-ret));
+    }
+    o->bufs[i] = empty;
+    o->bufs_busy[i] = 0;
+  }
+}
+
+static int find_buffer(uring_options_t * o, void * buf){
+  for(int i = 0; i < o->fixed_buffers; i++){
+    if(o->bufs[i].iov_base == buf){
+      return i;
+    }
+  }
+  return -1;
+}
+
+/* returns the index of the registered buffer covering buf, -1 if none is available */
+static int lookup_buffer(uring_options_t * o, void * buf, size_t len){
+  int i = find_buffer(o, buf);
+  if(i >= 0 && o->bufs[i].iov_len >= len){
+    return i;
+  }
+  if(i >= 0 && o->bufs_busy[i] != 0){
+    // registered with a shorter length and still in use
+    return -1;
+  }
+  // register the buffer in its own slot or in a slot that is currently unused
+  for(int n = 0; n < o->fixed_buffers; n++){
+    if(i < 0 || n > 0){
+      i = (o->bufs_next + n) % o->fixed_buffers;
+    }
+    if(o->bufs_busy[i] != 0){
+      continue;
+    }
+    struct iovec iov = {buf, len};
+    uint64_t tag = 0;
+    int ret = io_uring_register_buffers_update_tag(& o->ring, i, & iov, & tag, 1);
+    if(ret < 0){
+      WARNF("URING: cannot register buffer: %s", strerror(-ret));
+      return -1;
+    }
+    o->bufs[i] = iov;
+    o->bufs_next = (i + 1) % o->fixed_buffers;
+    return i;
+  }
+  return -1;
+}
+
+static void register_file(uring_options_t * o, uring_fd_t * fd){
+  if(! o->fixed_files){
+    return;
+  }
+  int ret = io_uring_register_files(& o->ring, (int*) fd->pfd, 1);
+  if(ret < 0){
+    ERRF("URING: cannot register file: %s", strerror(-ret));
+  }
+  o->file_registered = 1;
+}
+
+static aiori_fd_t *uring_Open(char *testFileName, int flags, aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  uring_fd_t * fd = malloc(sizeof(uring_fd_t));
+  fd->pfd = POSIX_Open(testFileName, flags, o->p);
+  if(fd->pfd != NULL){
+    register_file(o, fd);
+  }
+  return (aiori_fd_t*) fd;
+}
+
+static aiori_fd_t *uring_create(char *testFileName, int flags, aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  uring_fd_t * fd = malloc(sizeof(uring_fd_t));
+  fd->pfd = POSIX_Create(testFileName, flags, o->p);
+  if(fd->pfd != NULL){
+    register_file(o, fd);
+  }
+  return (aiori_fd_t*) fd;
+}
+
+static void push_done(uring_options_t * o, aiori_xfer_req_t * req){
+  if(o->done_count == o->done_size){
+    o->done_size = o->done_size == 0 ? o->entries : o->done_size * 2;
+    o->done = realloc(o->done, sizeof(aiori_xfer_req_t *) * o->done_size);
+    if(o->done == NULL){
+      ERR("URING, cannot allocate completion list");
+    }
+  }
+  o->done[o->done_count++] = req;
+}
+
+static void complete_cqe(uring_options_t * o, struct io_uring_cqe * cqe){
+  aiori_xfer_req_t * req = (aiori_xfer_req_t*) io_uring_cqe_get_data(cqe);
+  req->transferred = cqe->res;
+  if(o->fixed_buffers > 0){
+    // a buffer is registered in at most one slot
+    int i = find_buffer(o, req->buffer);
+    if(i >= 0 && o->bufs_busy[i] > 0){
+      o->bufs_busy[i]--;
+    }
+  }
+  if(req == o->sync_req){
+    o->sync_done = 1;
+    return;
+  }
+  push_done(o, req);
+}
+
+/* submit queued requests and wait until at least min requests completed */
+static int reap_cqes(uring_options_t * o, int min){
+  struct io_uring_cqe ** cqes = o->cqes;
+  int reaped = 0;
+  int ret;
+
+  if(min > o->in_flight){
+    min = o->in_flight;
+  }
+  ret = min > 0 ? io_uring_submit_and_wait(& o->ring, 1) : io_uring_submit(& o->ring);
+  if(ret < 0 && ret != -EINTR){
+    ERRF("URING: cannot submit requests: %s", strerror(-ret));
+  }
+  while(1){
+    unsigned count = io_uring_peek_batch_cqe(& o->ring, cqes, o->batch);
+    for(unsigned i = 0; i < count; i++){
+      complete_cqe(o, cqes[i]);
+    }
+    io_uring_cq_advance(& o->ring, count);
+    o->in_flight -= count;
+    reaped += count;
+    if(reaped >= min){
+      return reaped;
+    }
+    if(count == 0){
+      ret = io_uring_submit_and_wait(& o->ring, 1);
+      if(ret < 0 && ret != -EINTR){
+        ERRF("URING: cannot wait for completions: %s", strerror(-ret));
+      }
+    }
+  }
+}
+
+static void complete_all(uring_options_t * o){
+  while(o->in_flight > 0){
+    reap_cqes(o, o->in_flight);
+  }
+}
+
+static void queue_request(uring_options_t * o, uring_fd_t * fd, aiori_xfer_req_t * req){
+  struct io_uring_sqe * sqe;
+
+  if(o->in_flight >= o->entries){
+    reap_cqes(o, 1);
+  }
+  sqe = io_uring_get_sqe(& o->ring);
+  if(sqe == NULL){
+    // the submission queue is full of unsubmitted requests
+    int ret = io_uring_submit(& o->ring);
+    if(ret < 0){
+      ERRF("URING: cannot submit requests: %s", strerror(-ret));
+    }
+    sqe = io_uring_get_sqe(& o->ring);
+    if(sqe == NULL){
+      ERR("URING: submission queue is full");
+    }
+  }
+
+  int file = o->file_registered ? 0 : *(int*)fd->pfd;
+  int buf_index = o->fixed_buffers > 0 ? lookup_buffer(o, req->buffer, req->length) : -1;
+  if(buf_index >= 0){
+    o->bufs_busy[buf_index]++;
+    if(req->access == WRITE){
+      io_uring_prep_write_fixed(sqe, file, req->buffer, req->length, req->offset, buf_index);
+    }else{
+      io_uring_prep_read_fixed(sqe, file, req->buffer, req->length, req->offset, buf_index);
+    }
+  }else{
+    if(req->access == WRITE){
+      io_uring_prep_write(sqe, file, req->buffer, req->length, req->offset);
+    }else{
+      io_uring_prep_read(sqe, file, req->buffer, req->length, req->offset);
+    }
+  }
+  if(o->file_registered){
+    sqe->flags |= IOSQE_FIXED_FILE;
+  }
+  io_uring_sqe_set_data(sqe, req);
+  o->in_flight++;
+
+  if(io_uring_sq_ready(& o->ring) >= (unsigned) o->batch){
+    int ret = io_uring_submit(& o->ring);
+    if(ret < 0){
+      ERRF("URING: cannot submit requests: %s", strerror(-ret));
+    }
+  }
+}
+
+static IOR_offset_t uring_Xfer(int access, aiori_fd_t *fd, IOR_size_t * buffer,
+                               IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  IOR_offset_t remaining = length;
+  aiori_xfer_req_t req;
+
+  if(hints->dryRun)
+    return length;
+
+  while(remaining > 0){
+    req.access = access;
+    req.buffer = buffer;
+    req.length = remaining;
+    req.offset = offset;
+    req.transferred = 0;
+    o->sync_req = & req;
+    o->sync_done = 0;
+    queue_request(o, (uring_fd_t*) fd, & req);
+    while(! o->sync_done){
+      reap_cqes(o, 1);
+    }
+    o->sync_req = NULL;
+    if(req.transferred < 0){
+      ERRF("URING: %s failed at offset %lld: %s", access == WRITE ? "write" : "read", (long long) offset, strerror(-req.transferred));
+    }
+    if(req.transferred == 0){
+      ERRF("URING: %s returned 0 bytes at offset %lld", access == WRITE ? "write" : "read", (long long) offset);
+    }
+    if(req.transferred < remaining){
+      WARNF("task %d, partial %s, %lld of %lld bytes at offset %lld", rank, access == WRITE ? "write" : "read", (long long) req.transferred, (long long) remaining, (long long) offset);
+      if(hints->singleXferAttempt){
+        return length - remaining + req.transferred;
+      }
+    }
+    remaining -= req.transferred;
+    buffer = (IOR_size_t*) ((char*) buffer + req.transferred);
+    offset += req.transferred;
+  }
+  return length;
+}
+
+static int uring_xfer_submit(aiori_fd_t *fd, aiori_xfer_req_t * req, aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  if(hints->dryRun){
+    req->transferred = req->length;
+    push_done(o, req);
+    return 0;
+  }
+  queue_request(o, (uring_fd_t*) fd, req);
+  return 0;
+}
+
+static int pop_done(uring_options_t * o, aiori_xfer_req_t ** completed, int max){
+  int count = o->done_count < max ? o->done_count : max;
+  o->done_count -= count;
+  memcpy(completed, o->done + o->done_count, sizeof(aiori_xfer_req_t *) * count);
+  return count;
+}
+
+static int uring_xfer_poll(aiori_fd_t *fd, aiori_xfer_req_t ** completed, int max, aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  if(o->done_count < max && o->in_flight > 0){
+    reap_cqes(o, 0);
+  }
+  return pop_done(o, completed, max);
+}
+
+static int uring_xfer_wait(aiori_fd_t *fd, aiori_xfer_req_t ** completed, int min, int max, aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  if(o->done_count < min && o->in_flight > 0){
+    reap_cqes(o, min - o->done_count);
+  }
+  return pop_done(o, completed, max);
+}
+
+/* keep one submission batch in flight */
+static int uring_xfer_depth(aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  return o->batch;
+}
+
+static void uring_Close(aiori_fd_t *fd, aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  uring_fd_t * ufd = (uring_fd_t*) fd;
+  complete_all(o);
+  if(o->file_registered){
+    io_uring_unregister_files(& o->ring);
+    o->file_registered = 0;
+  }
+  if(o->fixed_buffers > 0){
+    clear_buffers(o);
+  }
+  POSIX_Close(ufd->pfd, o->p);
+  free(ufd);
+}
+
+static void uring_Fsync(aiori_fd_t *fd, aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  complete_all(o);
+  uring_fd_t * ufd = (uring_fd_t*) fd;
+  POSIX_Fsync(ufd->pfd, o->p);
+}
+
+static void uring_Sync(aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  complete_all(o);
+  POSIX_Sync((aiori_mod_opt_t*) o->p);
+}
+
+/*
+ * Bulk metadata operations, each path is one request, up to entries requests
+ * are submitted with a single system call.  Pending transfers are completed
+ * first, the completions of metadata requests carry the index of the path.
+ */
+enum { BULK_CREATE, BULK_CLOSE, BULK_STAT, BULK_REMOVE };
+
+typedef struct{
+  int op;
+  char ** paths;
+  int oflag;           /* BULK_CREATE: the flags of openat() */
+  int * fds;           /* BULK_CREATE: the opened files, BULK_CLOSE: the files to close */
+  struct statx * stx;  /* BULK_STAT */
+} uring_bulk_t;
+
+static void bulk_prep(uring_bulk_t * b, struct io_uring_sqe * sqe, int i){
+  switch(b->op){
+    case BULK_CREATE:
+      io_uring_prep_openat(sqe, AT_FDCWD, b->paths[i], b->oflag, 0664);
+      break;
+    case BULK_CLOSE:
+      io_uring_prep_close(sqe, b->fds[i]);
+      break;
+    case BULK_STAT:
+      io_uring_prep_statx(sqe, AT_FDCWD, b->paths[i], 0, STATX_BASIC_STATS, & b->stx[i]);
+      break;
+    case BULK_REMOVE:
+      io_uring_prep_unlinkat(sqe, AT_FDCWD, b->paths[i], 0);
+      break;
+  }
+  io_uring_sqe_set_data(sqe, (void*) (intptr_t) i);
+}
+
+/* runs the operation for all count paths, stores the result of a request in res[i] */
+static void bulk_run(uring_options_t * o, uring_bulk_t * b, int count, int * res){
+  struct io_uring_cqe ** cqes = o->cqes;
+
+  complete_all(o);
+  for(int start = 0; start < count; start += o->entries){
+    int n = count - start < o->entries ? count - start : o->entries;
+    for(int i = start; i < start + n; i++){
+      struct io_uring_sqe * sqe = io_uring_get_sqe(& o->ring);
+      if(sqe == NULL){
+        ERR("URING: submission queue is full");
+      }
+      bulk_prep(b, sqe, i);
+    }
+    int reaped = 0;
+    while(reaped < n){
+      int ret = io_uring_submit_and_wait(& o->ring, 1);
+      if(ret < 0 && ret != -EINTR){
+        ERRF("URING: cannot submit metadata requests: %s", strerror(-ret));
+      }
+      unsigned got = io_uring_peek_batch_cqe(& o->ring, cqes, o->batch);
+      for(unsigned k = 0; k < got; k++){
+        res[(intptr_t) io_uring_cqe_get_data(cqes[k])] = cqes[k]->res;
+      }
+      io_uring_cq_advance(& o->ring, got);
+      reaped += got;
+    }
+  }
+}
+
+static int bulk_errors(int * results, int count){
+  int errors = 0;
+  for(int i = 0; i < count; i++){
+    if(results[i] < 0){
+      errors++;
+    }else{
+      results[i] = 0;
+    }
+  }
+  return errors;
+}
+
+static int uring_bulk_create(char ** paths, int count, int iorflags, int * results, aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  uring_bulk_t b = {.op = BULK_CREATE, .paths = paths, .oflag = O_CREAT | O_RDWR};
+  int opened = 0;
+
+  if(hints->dryRun){
+    memset(results, 0, sizeof(int) * count);
+    return 0;
+  }
+  /* open the files like POSIX_Create() */
+  if(iorflags & IOR_EXCL){
+    b.oflag |= O_EXCL;
+  }
+  if(iorflags & IOR_TRUNC){
+    b.oflag |= O_TRUNC;
+  }
+  if(((posix_options_t*) o->p)->direct_io){
+    set_o_direct_flag(& b.oflag);
+  }
+  int * fds = safeMalloc(sizeof(int) * count);
+  int * close_res = safeMalloc(sizeof(int) * count);
+  bulk_run(o, & b, count, results);
+  for(int i = 0; i < count; i++){
+    if(results[i] >= 0){
+      fds[opened++] = results[i];
+    }
+  }
+  b.op = BULK_CLOSE;
+  b.fds = fds;
+  bulk_run(o, & b, opened, close_res);
+  free(fds);
+  free(close_res);
+  return bulk_errors(results, count);
+}
+
+static void statx_to_stat(const struct statx * x, struct stat * buf){
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_dev = makedev(x->stx_dev_major, x->stx_dev_minor);
+  buf->st_ino = x->stx_ino;
+  buf->st_mode = x->stx_mode;
+  buf->st_nlink = x->stx_nlink;
+  buf->st_uid = x->stx_uid;
+  buf->st_gid = x->stx_gid;
+  buf->st_rdev = makedev(x->stx_rdev_major, x->stx_rdev_minor);
+  buf->st_size = x->stx_size;
+  buf->st_blksize = x->stx_blksize;
+  buf->st_blocks = x->stx_blocks;
+  buf->st_atim.tv_sec = x->stx_atime.tv_sec;
+  buf->st_atim.tv_nsec = x->stx_atime.tv_nsec;
+  buf->st_mtim.tv_sec = x->stx_mtime.tv_sec;
+  buf->st_mtim.tv_nsec = x->stx_mtime.tv_nsec;
+  buf->st_ctim.tv_sec = x->stx_ctime.tv_sec;
+  buf->st_ctim.tv_nsec = x->stx_ctime.tv_nsec;
+}
+
+static int uring_bulk_stat(char ** paths, int count, struct stat * bufs, int * results, aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  uring_bulk_t b = {.op = BULK_STAT, .paths = paths};
+
+  if(hints->dryRun){
+    memset(bufs, 0, sizeof(struct stat) * count);
+    memset(results, 0, sizeof(int) * count);
+    return 0;
+  }
+  b.stx = safeMalloc(sizeof(struct statx) * count);
+  bulk_run(o, & b, count, results);
+  for(int i = 0; i < count; i++){
+    if(results[i] >= 0){
+      statx_to_stat(& b.stx[i], & bufs[i]);
+    }
+  }
+  free(b.stx);
+  return bulk_errors(results, count);
+}
+
+static int uring_bulk_remove(char ** paths, int count, int * results, aiori_mod_opt_t * param){
+  uring_options_t * o = (uring_options_t*) param;
+  uring_bulk_t b = {.op = BULK_REMOVE, .paths = paths};
+
+  if(hints->dryRun){
+    memset(results, 0, sizeof(int) * count);
+    return 0;
+  }
+  bulk_run(o, & b, count, results);
+  return bulk_errors(results, count);
+}
+
+
+ior_aiori_t uring_aiori = {
+        .name = "URING",
+        .name_legacy = NULL,
+        .create = uring_create,
+        .get_options = uring_options,
+        .initialize = uring_initialize,
+        .finalize = uring_finalize,
+        .xfer_hints = uring_xfer_hints,
+        .fsync = uring_Fsync,
+        .open = uring_Open,
+        .xfer = uring_Xfer,
+        .xfer_submit = uring_xfer_submit,
+        .xfer_poll = uring_xfer_poll,
+        .xfer_wait = uring_xfer_wait,
+        .xfer_depth = uring_xfer_depth,
+        .close = uring_Close,
+        .sync = uring_Sync,
+        .check_params = uring_check_params,
+        .remove = POSIX_Delete,
+        .get_version = aiori_get_version,
+        .get_file_size = POSIX_GetFileSize,
+        .statfs = aiori_posix_statfs,
+        .mkdir = aiori_posix_mkdir,
+        .rmdir = aiori_posix_rmdir,
+        .access = aiori_posix_access,
+        .stat = aiori_posix_stat,
+        .bulk_create = uring_bulk_create,
+        .bulk_stat = uring_bulk_stat,
+        .bulk_remove = uring_bulk_remove,
+        .enable_mdtest = true
+};
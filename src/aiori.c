@@ -17,6 +17,7 @@
 #endif
 
 #include <assert.h>
+#include <errno.h>
 #include <stdbool.h>
 
 #if defined(HAVE_STRINGS_H)
@@ -45,6 +46,9 @@ ior_aiori_t *available_aiori[] = {
 #ifdef USE_AIO_AIORI
         &aio_aiori,
 #endif
+#ifdef USE_URING_AIORI
+        &uring_aiori,
+#endif
 #ifdef USE_PMDK_AIORI
         &pmdk_aiori,
 #endif
@@ -241,6 +245,54 @@ int aiori_posix_stat (const char *path, struct stat *buf, aiori_mod_opt_t * modu
         return stat (path, buf);
 }
 
+int aiori_bulk_create(const ior_aiori_t * backend, char ** paths, int count, int iorflags, int * results, aiori_mod_opt_t * module_options)
+{
+        if (backend->bulk_create)
+                return backend->bulk_create(paths, count, iorflags, results, module_options);
+        int errors = 0;
+        for (int i = 0; i < count; i++) {
+                errno = 0;
+                aiori_fd_t *fd = backend->create(paths[i], iorflags, module_options);
+                if (fd == NULL) {
+                        results[i] = errno ? -errno : -EIO;
+                        errors++;
+                        continue;
+                }
+                backend->close(fd, module_options);
+                results[i] = 0;
+        }
+        return errors;
+}
+
+int aiori_bulk_stat(const ior_aiori_t * backend, char ** paths, int count, struct stat * bufs, int * results, aiori_mod_opt_t * module_options)
+{
+        if (backend->bulk_stat)
+                return backend->bulk_stat(paths, count, bufs, results, module_options);
+        int errors = 0;
+        for (int i = 0; i < count; i++) {
+                errno = 0;
+                if (backend->stat(paths[i], & bufs[i], module_options) != 0) {
+                        results[i] = errno ? -errno : -EIO;
+                        errors++;
+                } else {
+                        results[i] = 0;
+                }
+        }
+        return errors;
+}
+
+int aiori_bulk_remove(const ior_aiori_t * backend, char ** paths, int count, int * results, aiori_mod_opt_t * module_options)
+{
+        if (backend->bulk_remove)
+                return backend->bulk_remove(paths, count, results, module_options);
+        /* remove() does not report errors */
+        for (int i = 0; i < count; i++) {
+                backend->remove(paths[i], module_options);
+                results[i] = 0;
+        }
+        return 0;
+}
+
 char* aiori_get_version()
 {
   return "";
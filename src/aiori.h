@@ -85,6 +85,19 @@ typedef struct aiori_fd_t{
   void * dummy;
 } aiori_fd_t;
 
+/*
+ An asynchronous transfer request, see xfer_submit().
+ Between submission and completion the request and its buffer belong to the backend.
+ */
+typedef struct aiori_xfer_req_t{
+  int access;                      /* WRITE, READ or one of the check variants */
+  IOR_size_t * buffer;
+  IOR_offset_t length;
+  IOR_offset_t offset;
+  IOR_offset_t transferred;        /* set by the backend upon completion, negative on error */
+  void * user_data;                /* owned by the caller, untouched by the backend */
+} aiori_xfer_req_t;
+
 typedef struct ior_aiori {
         char *name;
         char *name_legacy;
@@ -113,7 +126,44 @@ typedef struct ior_aiori {
         option_help * (*get_options)(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt_t* init_values); /* initializes the backend options as well and returns the pointer to the option help structure */
         int (*check_params)(aiori_mod_opt_t *); /* check if the provided module_optionseters for the given test and the module options are correct, if they aren't print a message and exit(1) or return 1*/
         void (*sync)(aiori_mod_opt_t * ); /* synchronize every pending operation for this storage */
+        /*
+         Optional asynchronous transfer interface, used by IOR for all transfers if present.
+         xfer_submit() enqueues a request and returns 0 on success.
+         xfer_poll() returns up to max completed requests without blocking, xfer_wait() blocks
+         until at least min requests completed. Both return the number of requests stored in completed.
+         If a backend does not provide them, IOR falls back to synchronous xfer() calls.
+        */
+        int (*xfer_submit)(aiori_fd_t *, aiori_xfer_req_t * req, aiori_mod_opt_t * module_options);
+        int (*xfer_poll)(aiori_fd_t *, aiori_xfer_req_t ** completed, int max, aiori_mod_opt_t * module_options);
+        int (*xfer_wait)(aiori_fd_t *, aiori_xfer_req_t ** completed, int min, int max, aiori_mod_opt_t * module_options);
+        int (*xfer_depth)(aiori_mod_opt_t * module_options); /* preferred number of transfers in flight, used unless the queue depth is set */
+        void (*xfer_counts)(aiori_mod_opt_t * module_options, long long * counts); /* optional: stores the number of transfers and of data system calls issued for them in counts[0] and counts[1] since the last call, counted upon close */
+        /*
+         Optional bulk metadata interface, each call processes count paths.
+         bulk_create() creates and closes the files, bulk_stat() stores the
+         attributes of paths[i] in bufs[i]. The result of paths[i] is stored
+         in results[i], 0 on success or a negative errno value. All return the
+         number of failed paths. Use the aiori_bulk_*() functions, they fall
+         back to single-item calls if a backend does not provide them.
+        */
+        int (*bulk_create)(char ** paths, int count, int iorflags, int * results, aiori_mod_opt_t * module_options);
+        int (*bulk_stat)(char ** paths, int count, struct stat * bufs, int * results, aiori_mod_opt_t * module_options);
+        int (*bulk_remove)(char ** paths, int count, int * results, aiori_mod_opt_t * module_options);
+        /*
+         Optional parameter sweep, e.g., over MPI-IO hints. sweep_points() returns
+         the number of configurations described by the module options, IOR runs
+         every configuration as a test of its own: the options of each test are a
+         copy restricted by sweep_select() to point 0 .. points - 1.
+         sweep_describe() prints the requested configuration and the one the
+         storage reported while the test ran into the two buffers of size bytes,
+         it returns 0 if the options do not set any parameter of the sweep.
+        */
+        int (*sweep_points)(aiori_mod_opt_t * module_options);
+        void (*sweep_select)(aiori_mod_opt_t * module_options, int point);
+        int (*sweep_describe)(aiori_mod_opt_t * module_options, char * requested, char * effective, size_t size);
+        int (*filters_data)(aiori_mod_opt_t * module_options); /* optional: returns 1 if the module options transform the data on its way to storage, e.g., compress it, so that the stored size is reported along with the results */
         bool enable_mdtest;
+        bool thread_safe; /* xfer() and the asynchronous interface may be called concurrently by multiple threads of a task */
 } ior_aiori_t;
 
 enum bench_type {
@@ -123,6 +173,7 @@ enum bench_type {
 
 extern ior_aiori_t dummy_aiori;
 extern ior_aiori_t aio_aiori;
+extern ior_aiori_t uring_aiori;
 extern ior_aiori_t daos_aiori;
 extern ior_aiori_t dfs_aiori;
 extern ior_aiori_t hdf5_aiori;
@@ -154,6 +205,11 @@ void * airoi_update_module_options(const ior_aiori_t * backend, options_all_t *
 
 const char *aiori_default (void);
 
+/* bulk metadata operations, see ior_aiori_t */
+int aiori_bulk_create(const ior_aiori_t * backend, char ** paths, int count, int iorflags, int * results, aiori_mod_opt_t * module_options);
+int aiori_bulk_stat(const ior_aiori_t * backend, char ** paths, int count, struct stat * bufs, int * results, aiori_mod_opt_t * module_options);
+int aiori_bulk_remove(const ior_aiori_t * backend, char ** paths, int count, int * results, aiori_mod_opt_t * module_options);
+
 /* some generic POSIX-based backend calls */
 char * aiori_get_version (void);
 int aiori_posix_statfs (const char *path, ior_aiori_statfs_t *stat_buf, aiori_mod_opt_t * module_options);
@@ -172,6 +228,14 @@ typedef struct { /* if you change this datatype, e.g., adding more options, make
   int useSharedFilePointer;        /* use shared file pointer */
   int useStridedDatatype;          /* put strided access into datatype */
   char * hintsFileName;            /* full name for hints file */
+  int nonblocking;                 /* transfers posted per MPI_Waitall() */
+  int icollective;                 /* use nonblocking collective transfers */
+  int splitCollective;             /* use split collective transfers */
+  char * cbNodes;                  /* cb_nodes hint, a comma separated list is swept */
+  char * cbBufferSize;             /* cb_buffer_size hint, a comma separated list is swept */
+  char * cbMode;                   /* romio_cb_write and romio_cb_read hints, a comma separated list is swept */
+  char cbSelected[3][32];          /* the list items of a sweep point, see MPIIO_sweep_select() */
+  char cbEffective[4][32];         /* the collective buffering hints reported by MPI_File_get_info() */
 } mpiio_options_t;
 
 void MPIIO_Delete(char *testFileName, aiori_mod_opt_t * module_options);
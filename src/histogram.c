@@ -0,0 +1,113 @@
+#include <string.h>
+
+#include "histogram.h"
+#include "aiori-debug.h"
+
+static int sub_bits = LATENCY_HISTOGRAM_SUB_BITS;
+
+#define SUB_BUCKETS (1ull << sub_bits)
+/* buckets in use with the current precision */
+#define USED_BUCKETS ((LATENCY_HISTOGRAM_MAX_EXP - sub_bits + 2) << sub_bits)
+
+void latency_histogram_set_precision(int bits){
+  if(bits < 1 || bits > LATENCY_HISTOGRAM_MAX_SUB_BITS){
+    ERRF("latency histogram precision must be between 1 and %d bits, is %d", LATENCY_HISTOGRAM_MAX_SUB_BITS, bits);
+  }
+  sub_bits = bits;
+}
+
+static int bucket_index(uint64_t ns){
+  if(ns < SUB_BUCKETS){
+    return (int) ns;
+  }
+  int exp = 63 - __builtin_clzll(ns);
+  if(exp > LATENCY_HISTOGRAM_MAX_EXP){
+    return USED_BUCKETS - 1;
+  }
+  int shift = exp - sub_bits;
+  return ((shift + 1) << sub_bits) + (int) ((ns >> shift) - SUB_BUCKETS);
+}
+
+/* largest value that falls into the bucket */
+static uint64_t bucket_upper(int index){
+  if((uint64_t) index < SUB_BUCKETS){
+    return index;
+  }
+  int shift = (index >> sub_bits) - 1;
+  uint64_t sub = index & (SUB_BUCKETS - 1);
+  return ((SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+void latency_histogram_reset(latency_histogram_t * h){
+  memset(h, 0, sizeof(latency_histogram_t));
+}
+
+void latency_histogram_add(latency_histogram_t * h, double seconds){
+  uint64_t ns = seconds > 0 ? (uint64_t) (seconds * 1e9) : 0;
+  h->buckets[bucket_index(ns)]++;
+  if(h->count == 0 || ns < h->min_ns){
+    h->min_ns = ns;
+  }
+  h->count++;
+  if(ns > h->max_ns){
+    h->max_ns = ns;
+  }
+}
+
+void latency_histogram_merge(latency_histogram_t * dst, const latency_histogram_t * src){
+  for(int i = 0; i < USED_BUCKETS; i++){
+    dst->buckets[i] += src->buckets[i];
+  }
+  if(src->count > 0 && (dst->count == 0 || src->min_ns < dst->min_ns)){
+    dst->min_ns = src->min_ns;
+  }
+  dst->count += src->count;
+  if(src->max_ns > dst->max_ns){
+    dst->max_ns = src->max_ns;
+  }
+}
+
+void latency_histogram_reduce(latency_histogram_t * h, int root, MPI_Comm comm){
+  int rank;
+  uint64_t min_ns = h->count > 0 ? h->min_ns : UINT64_MAX;
+  MPI_CHECK(MPI_Comm_rank(comm, & rank), "cannot get rank");
+  if(rank == root){
+    MPI_CHECK(MPI_Reduce(MPI_IN_PLACE, & min_ns, 1, MPI_UINT64_T, MPI_MIN, root, comm), "cannot reduce histogram");
+    h->min_ns = min_ns;
+    MPI_CHECK(MPI_Reduce(MPI_IN_PLACE, h->buckets, USED_BUCKETS, MPI_UINT64_T, MPI_SUM, root, comm), "cannot reduce histogram");
+    MPI_CHECK(MPI_Reduce(MPI_IN_PLACE, & h->count, 1, MPI_UINT64_T, MPI_SUM, root, comm), "cannot reduce histogram");
+    MPI_CHECK(MPI_Reduce(MPI_IN_PLACE, & h->max_ns, 1, MPI_UINT64_T, MPI_MAX, root, comm), "cannot reduce histogram");
+  }else{
+    MPI_CHECK(MPI_Reduce(& min_ns, NULL, 1, MPI_UINT64_T, MPI_MIN, root, comm), "cannot reduce histogram");
+    MPI_CHECK(MPI_Reduce(h->buckets, NULL, USED_BUCKETS, MPI_UINT64_T, MPI_SUM, root, comm), "cannot reduce histogram");
+    MPI_CHECK(MPI_Reduce(& h->count, NULL, 1, MPI_UINT64_T, MPI_SUM, root, comm), "cannot reduce histogram");
+    MPI_CHECK(MPI_Reduce(& h->max_ns, NULL, 1, MPI_UINT64_T, MPI_MAX, root, comm), "cannot reduce histogram");
+  }
+}
+
+double latency_histogram_quantile(const latency_histogram_t * h, double q){
+  if(h->count == 0){
+    return 0;
+  }
+  uint64_t rank = (uint64_t) (q * h->count + 0.5);
+  uint64_t seen = 0;
+  if(rank < 1){
+    rank = 1;
+  }
+  for(int i = 0; i < USED_BUCKETS; i++){
+    seen += h->buckets[i];
+    if(seen >= rank){
+      uint64_t upper = bucket_upper(i);
+      return (upper < h->max_ns ? upper : h->max_ns) * 1e-9;
+    }
+  }
+  return h->max_ns * 1e-9;
+}
+
+double latency_histogram_min(const latency_histogram_t * h){
+  return h->count > 0 ? h->min_ns * 1e-9 : 0;
+}
+
+double latency_histogram_max(const latency_histogram_t * h){
+  return h->max_ns * 1e-9;
+}
@@ -0,0 +1,42 @@
+#ifndef _IOR_HISTOGRAM_H
+#define _IOR_HISTOGRAM_H
+
+#include <stdint.h>
+#include <mpi.h>
+
+/*
+ * Log-linear latency histogram in the style of HdrHistogram.
+ * Every power of two of nanoseconds is split into 2^bits buckets, so a
+ * recorded value is off by at most 2^-bits.  bits is set for all histograms
+ * of the process with latency_histogram_set_precision(), by default
+ * LATENCY_HISTOGRAM_SUB_BITS (1/32, 3.1%), at most
+ * LATENCY_HISTOGRAM_MAX_SUB_BITS, which sizes the bucket array.
+ * Values above 2^(LATENCY_HISTOGRAM_MAX_EXP+1) ns (about 73 minutes) are
+ * counted in the last bucket, the maximum is kept exactly.
+ */
+#define LATENCY_HISTOGRAM_SUB_BITS 5
+#define LATENCY_HISTOGRAM_MAX_SUB_BITS 7
+#define LATENCY_HISTOGRAM_MAX_EXP 41
+#define LATENCY_HISTOGRAM_BUCKETS ((LATENCY_HISTOGRAM_MAX_EXP - LATENCY_HISTOGRAM_MAX_SUB_BITS + 2) << LATENCY_HISTOGRAM_MAX_SUB_BITS)
+
+typedef struct{
+  uint64_t count;
+  uint64_t min_ns;  /* only valid if count > 0 */
+  uint64_t max_ns;
+  uint64_t buckets[LATENCY_HISTOGRAM_BUCKETS];
+} latency_histogram_t;
+
+/* set the buckets per power of two to 2^bits, before any value is recorded */
+void latency_histogram_set_precision(int bits);
+void latency_histogram_reset(latency_histogram_t * h);
+/* record a latency in seconds */
+void latency_histogram_add(latency_histogram_t * h, double seconds);
+void latency_histogram_merge(latency_histogram_t * dst, const latency_histogram_t * src);
+/* merge the histograms of all processes of comm on process root */
+void latency_histogram_reduce(latency_histogram_t * h, int root, MPI_Comm comm);
+/* returns the latency in seconds that is not exceeded by the fraction q of values, 0 if empty */
+double latency_histogram_quantile(const latency_histogram_t * h, double q);
+double latency_histogram_min(const latency_histogram_t * h);
+double latency_histogram_max(const latency_histogram_t * h);
+
+#endif
@@ -21,7 +21,12 @@ void PrintTableHeader(){
     fprintf(out_resultfile, "access    bw(MiB/s)  IOPS       Latency(s)  block(KiB) xfer(KiB)  open(s)    wr/rd(s)   close(s)   total(s)   iter\n");
     fprintf(out_resultfile, "------    ---------  ----       ----------  ---------- ---------  --------   --------   --------   --------   ----\n");
   }else if(outputFormat == OUTPUT_CSV){
-    fprintf(out_resultfile, "access,bw(MiB/s),IOPS,Latency,block(KiB),xfer(KiB),open(s),wr/rd(s),close(s),total(s),numTasks,iter\n");
+    fprintf(out_resultfile, "access,bw(MiB/s),IOPS,Latency,block(KiB),xfer(KiB),open(s),wr/rd(s),close(s),total(s),numTasks,iter");
+    const char * kinds[] = {"xfer", "open", "close"};
+    for(int i = 0; i < 3; i++){
+      fprintf(out_resultfile, ",%s p50(us),%s p90(us),%s p99(us),%s p99.9(us),%s max(us)", kinds[i], kinds[i], kinds[i], kinds[i], kinds[i]);
+    }
+    fprintf(out_resultfile, "\n");
   }
 }
 
@@ -226,8 +231,43 @@ void PrintTestEnds(){
   PrintEndSection();
 }
 
-void PrintReducedResult(IOR_test_t *test, int access, double bw, double iops, double latency,
+/*
+ * Print the percentiles of a latency histogram in microseconds,
+ * as named section for JSON and as columns for CSV.
+ */
+static void PrintLatencyPercentiles(char * name, const latency_histogram_t * h){
+  double values[] = {latency_histogram_quantile(h, 0.5), latency_histogram_quantile(h, 0.9),
+    latency_histogram_quantile(h, 0.99), latency_histogram_quantile(h, 0.999), latency_histogram_max(h)};
+  if(outputFormat == OUTPUT_JSON){
+    PrintNamedSectionStart(name);
+    PrintKeyValInt("count", h->count);
+    PrintKeyValDouble("p50us", values[0] * 1e6);
+    PrintKeyValDouble("p90us", values[1] * 1e6);
+    PrintKeyValDouble("p99us", values[2] * 1e6);
+    PrintKeyValDouble("p99.9us", values[3] * 1e6);
+    PrintKeyValDouble("maxus", values[4] * 1e6);
+    PrintEndSection();
+  }else if(outputFormat == OUTPUT_CSV){
+    for(int i = 0; i < 5; i++){
+      fprintf(out_resultfile, ",%.1f", values[i] * 1e6);
+    }
+  }else{
+    fprintf(out_resultfile, "%-12s %10llu", name, (unsigned long long) h->count);
+    for(int i = 0; i < 5; i++){
+      fprintf(out_resultfile, " %10.1f", values[i] * 1e6);
+    }
+  }
+}
+
+void PrintReducedResult(IOR_test_t *test, const IOR_point_t *point, int access, double bw, double iops, double latency,
 			double *diff_subset, double totalTime, int rep){
+  /* filters of the backend, e.g., compression, store fewer (or more) bytes than accessed */
+  const ior_aiori_t *backend = test->params.backend;
+  double stored = 0;
+  if (backend->filters_data && backend->filters_data(test->params.backend_options)
+      && point->aggFileSizeFromStat > 0){
+    stored = (double) point->aggFileSizeFromStat;
+  }
   if (outputFormat == OUTPUT_DEFAULT){
     fprintf(out_resultfile, "%-10s", access == WRITE ? "write" : "read");
     PPDouble(1, bw / MEBIBYTE, " ");
@@ -240,10 +280,28 @@ void PrintReducedResult(IOR_test_t *test, int access, double bw, double iops, do
     PPDouble(1, diff_subset[2], " ");
     PPDouble(1, totalTime, " ");
     fprintf(out_resultfile, "%-4d\n", rep);
+    if (stored > 0){
+      fprintf(out_resultfile, "%-10s", "stored");
+      PPDouble(1, stored / totalTime / MEBIBYTE, " ");
+      fprintf(out_resultfile, "MiB/s for %.2f MiB, ratio %.2f\n", stored / MEBIBYTE,
+              (double) point->aggFileSizeForBW / stored);
+    }
+    if (point->syscalls > 0){
+      fprintf(out_resultfile, "%-10s%lld for %lld transfers, %.2f transfers per call\n", "syscalls",
+              point->syscalls, point->transfers, (double) point->transfers / point->syscalls);
+    }
   }else if (outputFormat == OUTPUT_JSON){
     PrintStartSection();
     PrintKeyVal("access", access == WRITE ? "write" : "read");
     PrintKeyValDouble("bwMiB", bw / MEBIBYTE);
+    if (stored > 0){
+      PrintKeyValDouble("storedBwMiB", stored / totalTime / MEBIBYTE);
+      PrintKeyValDouble("storedMiB", stored / MEBIBYTE);
+    }
+    if (point->syscalls > 0){
+      PrintKeyValInt("transfers", point->transfers);
+      PrintKeyValInt("syscalls", point->syscalls);
+    }
     PrintKeyValDouble("blockKiB", (double)test->params.blockSize / KIBIBYTE);
     PrintKeyValDouble("xferKiB", (double)test->params.transferSize / KIBIBYTE);
     PrintKeyValDouble("iops", iops);
@@ -252,6 +310,9 @@ void PrintReducedResult(IOR_test_t *test, int access, double bw, double iops, do
     PrintKeyValDouble("wrRdTime", diff_subset[1]);
     PrintKeyValDouble("closeTime", diff_subset[2]);
     PrintKeyValDouble("totalTime", totalTime);
+    PrintLatencyPercentiles("xferLatency", & point->xfer_latency);
+    PrintLatencyPercentiles("openLatency", & point->open_latency);
+    PrintLatencyPercentiles("closeLatency", & point->close_latency);
     PrintEndSection();
   }else if (outputFormat == OUTPUT_CSV){
     PrintKeyVal("access", access == WRITE ? "write" : "read");
@@ -265,7 +326,11 @@ void PrintReducedResult(IOR_test_t *test, int access, double bw, double iops, do
     PrintKeyValDouble("closeTime", diff_subset[2]);
     PrintKeyValDouble("totalTime", totalTime);
     PrintKeyValInt("Numtasks", test->params.numTasks);
-    fprintf(out_resultfile, "%d\n", rep);
+    fprintf(out_resultfile, "%d", rep);
+    PrintLatencyPercentiles("xferLatency", & point->xfer_latency);
+    PrintLatencyPercentiles("openLatency", & point->open_latency);
+    PrintLatencyPercentiles("closeLatency", & point->close_latency);
+    fprintf(out_resultfile, "\n");
   }
 
   fflush(out_resultfile);
@@ -390,6 +455,9 @@ void ShowTestStart(IOR_param_t *test)
     //#endif
     PrintKeyValInt("transferSize", test->transferSize);
     PrintKeyValInt("blockSize", test->blockSize);
+    PrintKeyValInt("queueDepth", test->queueDepth);
+    PrintKeyValInt("threadsPerRank", test->threadsPerRank);
+    PrintKeyValInt("computeOverlapUs", test->computeOverlapUs);
     PrintEndSection();
   }
 
@@ -459,6 +527,15 @@ void ShowSetup(IOR_param_t *params)
   PrintKeyVal("xfersize", HumanReadable(params->transferSize, BASE_TWO));
   PrintKeyVal("blocksize", HumanReadable(params->blockSize, BASE_TWO));
   PrintKeyVal("aggregate filesize", HumanReadable(params->expectedAggFileSize, BASE_TWO));
+  if(params->queueDepth > 1){
+    PrintKeyValInt("queueDepth", params->queueDepth);
+  }
+  if(params->threadsPerRank > 1){
+    PrintKeyValInt("threadsPerRank", params->threadsPerRank);
+  }
+  if(params->computeOverlapUs > 0){
+    PrintKeyValInt("computeOverlapUs", params->computeOverlapUs);
+  }
   if(params->dryRun){
     PrintKeyValInt("dryRun", params->dryRun);
   }
@@ -530,6 +607,23 @@ static struct results *ops_values(const int reps, IOR_results_t *measured,
         return bw_ops_values(reps, measured, transfer_size, vals, access);
 }
 
+/*
+ * Merge the transfer, open and close latencies of all repetitions,
+ * returns an array of three histograms.
+ */
+static latency_histogram_t * MergeLatencies(IOR_test_t *test, const int access)
+{
+        latency_histogram_t * merged = safeMalloc(3 * sizeof(latency_histogram_t));
+        for (int i = 0; i < test->params.repetitions; i++) {
+                IOR_point_t *point = (access == WRITE) ? &test->results[i].write :
+                                                         &test->results[i].read;
+                latency_histogram_merge(& merged[0], & point->xfer_latency);
+                latency_histogram_merge(& merged[1], & point->open_latency);
+                latency_histogram_merge(& merged[2], & point->close_latency);
+        }
+        return merged;
+}
+
 /*
  * Summarize results
  */
@@ -629,6 +723,11 @@ static void PrintLongSummaryOneOperation(IOR_test_t *test, const int access)
             PrintKeyValDouble("StoneWallbwMeanMIB", stonewall_avg_data_accessed / stonewall_time / MEBIBYTE);
           }
           PrintKeyValDouble("xsizeMiB", (double) point->aggFileSizeForBW / MEBIBYTE);
+          latency_histogram_t * latencies = MergeLatencies(test, access);
+          PrintLatencyPercentiles("xferLatency", & latencies[0]);
+          PrintLatencyPercentiles("openLatency", & latencies[1]);
+          PrintLatencyPercentiles("closeLatency", & latencies[2]);
+          free(latencies);
           PrintEndSection();
         }
 
@@ -668,6 +767,131 @@ void PrintLongSummaryHeader()
         fprintf(out_resultfile, " RefNum\n");
 }
 
+static void PrintLatencySummaryOneOperation(IOR_test_t *test, const int access)
+{
+        const char * names[] = {"", "-open", "-close"};
+        latency_histogram_t * latencies = MergeLatencies(test, access);
+        for (int i = 0; i < 3; i++) {
+                char name[20];
+                sprintf(name, "%s%s", access == WRITE ? "write" : "read", names[i]);
+                PrintLatencyPercentiles(name, & latencies[i]);
+                fprintf(out_resultfile, " %5d\n", test->params.id);
+        }
+        free(latencies);
+}
+
+/*
+ * Print the latency percentiles in microseconds of all repetitions,
+ * JSON output contains them in the summary of each operation.
+ */
+void PrintLatencySummaryOneTest(IOR_test_t *test)
+{
+        IOR_param_t *params = &test->params;
+
+        if (rank != 0 || verbose <= VERBOSE_0 || outputFormat != OUTPUT_DEFAULT)
+                return;
+        if (params->writeFile)
+                PrintLatencySummaryOneOperation(test, WRITE);
+        if (params->readFile || params->checkRead)
+                PrintLatencySummaryOneOperation(test, READ);
+}
+
+void PrintLatencySummaryHeader()
+{
+        if (rank != 0 || verbose <= VERBOSE_0 || outputFormat != OUTPUT_DEFAULT)
+                return;
+
+        fprintf(out_resultfile, "\n");
+        fprintf(out_resultfile, "Latency(us)  %10s %10s %10s %10s %10s %10s %5s\n",
+                "Count", "p50", "p90", "p99", "p99.9", "Max", "Test#");
+}
+
+static double MeanBandwidth(IOR_test_t *test, const int access)
+{
+        int reps = test->params.repetitions;
+        double * times = safeMalloc(sizeof(double) * reps);
+        for (int i = 0; i < reps; i++)
+                times[i] = (access == WRITE) ? test->results[i].write.time : test->results[i].read.time;
+        struct results *bw = bw_values(reps, test->results, times, access);
+        double mean = bw->mean;
+        free(bw);
+        free(times);
+        return mean;
+}
+
+/*
+ * Compare the tests of a parameter sweep, see sweep_points() of the backend,
+ * and name the configuration with the best mean write and read bandwidth.
+ */
+static void PrintSweepSummary(IOR_test_t *tests_head)
+{
+        const int access[2] = {WRITE, READ};
+        IOR_test_t *tptr, *best[2] = {NULL, NULL};
+        double best_bw[2] = {0, 0};
+        char requested[256];
+        char effective[256];
+        int header = 0;
+
+        for (tptr = tests_head; tptr != NULL; tptr = tptr->next) {
+                IOR_param_t *params = &tptr->params;
+                if (params->backend->sweep_describe == NULL
+                    || ! params->backend->sweep_describe(params->backend_options, requested, effective, sizeof(requested)))
+                        continue;
+                double bw[2];
+                for (int i = 0; i < 2; i++) {
+                        int done = (access[i] == WRITE) ? params->writeFile : (params->readFile || params->checkRead);
+                        bw[i] = done ? MeanBandwidth(tptr, access[i]) : 0;
+                        if (done && bw[i] > best_bw[i]) {
+                                best_bw[i] = bw[i];
+                                best[i] = tptr;
+                        }
+                }
+
+                if (! header) {
+                        if (outputFormat == OUTPUT_DEFAULT) {
+                                fprintf(out_resultfile, "\n%s configurations:\n", params->api);
+                                fprintf(out_resultfile, "%5s %12s %12s  %-48s %s\n", "Test#",
+                                        "Write(MiB)", "Read(MiB)", "Requested", "Effective");
+                        } else if (outputFormat == OUTPUT_JSON) {
+                                PrintNamedArrayStart("sweep");
+                        }
+                        header = 1;
+                }
+                if (outputFormat == OUTPUT_DEFAULT) {
+                        fprintf(out_resultfile, "%5d %12.2f %12.2f  %-48s %s\n", params->id,
+                                bw[0] / MEBIBYTE, bw[1] / MEBIBYTE, requested, effective);
+                } else if (outputFormat == OUTPUT_JSON) {
+                        PrintStartSection();
+                        PrintKeyValInt("TestID", params->id);
+                        PrintKeyVal("requested", requested);
+                        PrintKeyVal("effective", effective);
+                        PrintKeyValDouble("writeMeanMiB", bw[0] / MEBIBYTE);
+                        PrintKeyValDouble("readMeanMiB", bw[1] / MEBIBYTE);
+                        PrintEndSection();
+                }
+        }
+        if (! header)
+                return;
+
+        if (outputFormat == OUTPUT_DEFAULT) {
+                for (int i = 0; i < 2; i++) {
+                        if (best[i] == NULL)
+                                continue;
+                        best[i]->params.backend->sweep_describe(best[i]->params.backend_options,
+                                                                requested, effective, sizeof(requested));
+                        fprintf(out_resultfile, "Best %-5s %10.2f MiB/s test %d: %s (%s)\n",
+                                access[i] == WRITE ? "write" : "read", best_bw[i] / MEBIBYTE,
+                                best[i]->params.id, requested, effective);
+                }
+        } else if (outputFormat == OUTPUT_JSON) {
+                PrintArrayEnd();
+                if (best[0])
+                        PrintKeyValInt("sweepBestWriteTestID", best[0]->params.id);
+                if (best[1])
+                        PrintKeyValInt("sweepBestReadTestID", best[1]->params.id);
+        }
+}
+
 void PrintLongSummaryAllTests(IOR_test_t *tests_head)
 {
   IOR_test_t *tptr;
@@ -689,7 +913,14 @@ void PrintLongSummaryAllTests(IOR_test_t *tests_head)
     PrintLongSummaryOneTest(tptr);
   }
 
+  PrintLatencySummaryHeader();
+  for (tptr = tests_head; tptr != NULL; tptr = tptr->next) {
+    PrintLatencySummaryOneTest(tptr);
+  }
+
   PrintArrayEnd();
+
+  PrintSweepSummary(tests_head);
 }
 
 void PrintShortSummary(IOR_test_t * test)
@@ -28,6 +28,7 @@
 
 #include <sys/stat.h>           /* struct stat */
 #include <time.h>
+#include <pthread.h>
 
 #ifndef _WIN32
 # include <sys/time.h>           /* gettimeofday() */
@@ -180,6 +181,13 @@ static int test_initialize(IOR_test_t * test){
   ior_set_xfer_hints(& test->params);
   aiori_warning_as_errors = test->params.warningAsErrors;
 
+  if(test->params.queueDepth == 0){
+    test->params.queueDepth = 1;
+    if(backend->xfer_depth){
+      test->params.queueDepth = backend->xfer_depth(test->params.backend_options);
+    }
+  }
+
   if (rank == 0 && verbose >= VERBOSE_0) {
     ShowTestStart(& test->params);
   }
@@ -238,22 +246,24 @@ int ior_main(int argc, char **argv)
     int skip_mpi_finalize = 0;
     const char *ior_comm_self_env = NULL;
     int world_rank = 0;
-    int required_thread_level = MPI_THREAD_SINGLE;
+    /*
+     * The threads of --threads-per-rank may abort through ERR(), the level
+     * is checked once the options are parsed.
+     */
+    int required_thread_level = MPI_THREAD_MULTIPLE;
     int provided_thread_level = MPI_THREAD_SINGLE;
 
     out_logfile = stdout;
     out_resultfile = stdout;
 
-    if (envEnabled("LIBOMPFILE_MPP_OPEN") && envEnabled("LIBOMPFILE_MPP_IO"))
-        required_thread_level = MPI_THREAD_MULTIPLE;
+    int mpp_io = envEnabled("LIBOMPFILE_MPP_OPEN") && envEnabled("LIBOMPFILE_MPP_IO");
 
     /* start the MPI code */
     MPI_CHECK(MPI_Init_thread(&argc, &argv, required_thread_level,
                               &provided_thread_level),
               "cannot initialize MPI");
 
-    if (required_thread_level == MPI_THREAD_MULTIPLE &&
-        provided_thread_level < MPI_THREAD_MULTIPLE) {
+    if (mpp_io && provided_thread_level < MPI_THREAD_MULTIPLE) {
             fprintf(stderr,
                     "[ior-mpp] error: MPI thread level is %s, but "
                     "LIBOMPFILE_MPP_OPEN=1 and LIBOMPFILE_MPP_IO=1 require %s.\n",
@@ -373,6 +383,8 @@ void init_IOR_Param_t(IOR_param_t * p, MPI_Comm com)
         p->segmentCount = 1;
         p->blockSize = 1048576;
         p->transferSize = 262144;
+        p->queueDepth = 0;
+        p->threadsPerRank = 1;
         p->randomSeed = -1;
         p->incompressibleSeed = 573;
         p->testComm = com; // this com might change for smaller tests
@@ -832,6 +844,21 @@ static char *PrependDir(IOR_param_t * test, char *rootDir)
 /*
  * Reduce test results, and show if verbose set.
  */
+/*
+ * The transfers and data system calls of the backend since the last call,
+ * summed over all tasks on rank 0.
+ */
+static void ReduceXferCounts(IOR_param_t *params, long long *reduced)
+{
+        long long counts[2] = {0, 0};
+
+        reduced[0] = reduced[1] = 0;
+        if (backend->xfer_counts == NULL)
+                return;
+        backend->xfer_counts(params->backend_options, counts);
+        MPI_CHECK(MPI_Reduce(counts, reduced, 2, MPI_LONG_LONG, MPI_SUM, 0, testComm), "MPI_Reduce()");
+}
+
 static void
 ReduceIterResults(IOR_test_t *test, double *timer, const int rep, const int access)
 {
@@ -865,6 +892,17 @@ ReduceIterResults(IOR_test_t *test, double *timer, const int rep, const int acce
 
         point->time = totalTime;
 
+        latency_histogram_add(&point->open_latency, timer[IOR_TIMER_OPEN_STOP] - timer[IOR_TIMER_OPEN_START]);
+        latency_histogram_add(&point->close_latency, timer[IOR_TIMER_CLOSE_STOP] - timer[IOR_TIMER_CLOSE_START]);
+        latency_histogram_reduce(&point->xfer_latency, 0, testComm);
+        latency_histogram_reduce(&point->open_latency, 0, testComm);
+        latency_histogram_reduce(&point->close_latency, 0, testComm);
+
+        long long counts[2];
+        ReduceXferCounts(params, counts);
+        point->transfers = counts[0];
+        point->syscalls = counts[1];
+
         if (verbose < VERBOSE_0)
                 return;
 
@@ -886,7 +924,7 @@ ReduceIterResults(IOR_test_t *test, double *timer, const int rep, const int acce
         if (rank != 0)
                 return;
 
-        PrintReducedResult(test, access, bw, iops, latency, diff, totalTime, rep);
+        PrintReducedResult(test, point, access, bw, iops, latency, diff, totalTime, rep);
 }
 
 /*
@@ -993,11 +1031,18 @@ static void InitTests(IOR_test_t *tests)
 
 /*
  * Setup transfer buffers, creating and filling as needed.
+ * One buffer is allocated for every transfer that may be in flight,
+ * thread t of a task uses the queueDepth buffers starting at ring[t * queueDepth].
  */
 static void XferBuffersSetup(IOR_io_buffers* ioBuffers, IOR_param_t* test,
                              int pretendRank)
 {
-        ioBuffers->buffer = aligned_buffer_alloc(test->transferSize, test->gpuMemoryFlags);
+        ioBuffers->ringSize = test->queueDepth * test->threadsPerRank;
+        ioBuffers->ring = safeMalloc(sizeof(void *) * ioBuffers->ringSize);
+        for (int i = 0; i < ioBuffers->ringSize; i++) {
+                ioBuffers->ring[i] = aligned_buffer_alloc(test->transferSize, test->gpuMemoryFlags);
+        }
+        ioBuffers->buffer = ioBuffers->ring[0];
 }
 
 /*
@@ -1006,7 +1051,12 @@ static void XferBuffersSetup(IOR_io_buffers* ioBuffers, IOR_param_t* test,
 static void XferBuffersFree(IOR_io_buffers* ioBuffers, IOR_param_t* test)
 
 {
-        aligned_buffer_free(ioBuffers->buffer, test->gpuMemoryFlags);
+        for (int i = 0; i < ioBuffers->ringSize; i++) {
+                aligned_buffer_free(ioBuffers->ring[i], test->gpuMemoryFlags);
+        }
+        free(ioBuffers->ring);
+        ioBuffers->ring = NULL;
+        ioBuffers->buffer = NULL;
 }
 
 
@@ -1245,6 +1295,7 @@ static void TestIoSys(IOR_test_t *test)
         IOR_results_t *results = test->results;
         char testFileName[MAX_STR];
         double timer[IOR_NB_TIMERS];
+        long long xferCounts[2];
         double startTime;
         int pretendRank;
         int rep;
@@ -1311,7 +1362,9 @@ static void TestIoSys(IOR_test_t *test)
                           (&params->timeStampSignatureValue, 1, MPI_UNSIGNED, 0,
                            testComm), "cannot broadcast start time value");
 
-                generate_memory_pattern((char*) ioBuffers.buffer, params->transferSize, params->timeStampSignatureValue, pretendRank, params->dataPacketType, params->gpuMemoryFlags);
+                for (int i = 0; i < ioBuffers.ringSize; i++) {
+                        generate_memory_pattern((char*) ioBuffers.ring[i], params->transferSize, params->timeStampSignatureValue, pretendRank, params->dataPacketType, params->gpuMemoryFlags);
+                }
 
                 /* use repetition count for number of multiple files */
                 if (params->multiFile)
@@ -1336,6 +1389,7 @@ static void TestIoSys(IOR_test_t *test)
                         params->stoneWallingWearOutIterations = params_saved_wearout;
                         MPI_CHECK(MPI_Barrier(testComm), "barrier error");
                         params->open = WRITE;
+                        ReduceXferCounts(params, xferCounts); /* discard the counts of earlier phases */
                         timer[IOR_TIMER_OPEN_START] = GetTimeStamp();
                         fd = backend->create(testFileName, IOR_WRONLY | IOR_CREAT | IOR_TRUNC, params->backend_options);
                         if(fd == NULL) FAIL("Cannot create file");
@@ -1433,8 +1487,8 @@ static void TestIoSys(IOR_test_t *test)
                         }
                         /* random process offset reading */
                         if (params->reorderTasksRandom == 1) {
-                                /* this should not intefere with randomOffset within a file because GetOffsetArrayRandom */
-                                /* seeds every rand() call  */
+                                /* this does not intefere with randomOffset within a file, the shuffled */
+                                /* offsets of GetOffsetShuffle() do not use rand() */
                                 int nodeoffset;
                                 unsigned int iseed0;
                                 nodeoffset = params->taskPerNodeOffset;
@@ -1494,6 +1548,7 @@ static void TestIoSys(IOR_test_t *test)
                         DelaySecs(params->interTestDelay);
                         MPI_CHECK(MPI_Barrier(testComm), "barrier error");
                         params->open = READ;
+                        ReduceXferCounts(params, xferCounts); /* discard the counts of earlier phases */
                         timer[IOR_TIMER_OPEN_START] = GetTimeStamp();
                         fd = backend->open(testFileName, IOR_RDONLY, params->backend_options);
                         if(fd == NULL) FAIL("Cannot open file");
@@ -1544,6 +1599,8 @@ static void TestIoSys(IOR_test_t *test)
         if (params->summary_every_test) {
                 PrintLongSummaryHeader();
                 PrintLongSummaryOneTest(test);
+                PrintLatencySummaryHeader();
+                PrintLatencySummaryOneTest(test);
         } else {
                 PrintShortSummary(test);
         }
@@ -1566,6 +1623,8 @@ static void ValidateTests(IOR_param_t * test, MPI_Comm com)
           ERR("GPUDirect requires a non-CPU memory type");
         if (test->gpuMemoryFlags == IOR_MEMORY_TYPE_GPU_DEVICE_ONLY && ! test->gpuDirect )
           ERR("Using GPU Device memory only requires the usage of GPUDirect");
+        if (test->dataPacketType == DATA_COMPRESSIBLE && (test->gpuMemoryFlags == IOR_MEMORY_TYPE_GPU_MANAGED_CHECK_GPU || test->gpuMemoryFlags == IOR_MEMORY_TYPE_GPU_DEVICE_ONLY))
+          ERR("The compressible data packet type is not available for patterns on the GPU, use allocateBufferOnGPU=1");
         if (test->stoneWallingStatusFile && test->keepFile == 0)
           ERR("a StoneWallingStatusFile is only sensible when splitting write/read into multiple executions of ior, please use -k");
         if (test->stoneWallingStatusFile && test->stoneWallingWearOut == 0 && test->writeFile)
@@ -1611,6 +1670,27 @@ static void ValidateTests(IOR_param_t * test, MPI_Comm com)
           ERR("Setting the randomPrefill option without using random is not useful");
         if (test->randomPrefillBlocksize && (test->blockSize % test->randomPrefillBlocksize != 0))
           ERR("The randomPrefill option must divide the blockSize");
+        if (test->queueDepth < 0)
+          ERR("The queue depth must not be negative");
+        if (test->computeOverlapUs < 0)
+          ERR("The compute overlap must not be negative");
+        if (test->threadsPerRank < 1)
+          ERR("The number of threads per rank must be positive");
+        if (test->threadsPerRank > 1) {
+          int level;
+          MPI_CHECK(MPI_Query_thread(&level), "cannot query the MPI thread level");
+          if (level < MPI_THREAD_MULTIPLE)
+            ERRF("Multiple threads per rank require MPI_THREAD_MULTIPLE, MPI provides %s",
+                 mpiThreadLevelToString(level));
+          if (test->collective)
+            ERR("Collective I/O cannot be issued by multiple threads per rank");
+          if (test->randomOffset > 1)
+            ERR("Multiple threads per rank support only shuffled offsets (-z once)");
+          if (test->randomPrefillBlocksize)
+            ERR("The randomPrefill option cannot be used with multiple threads per rank");
+          if (test->stoneWallingWearOut)
+            ERR("Stonewalling wear out cannot be used with multiple threads per rank");
+        }
         /* specific APIs */
         if ((strcasecmp(test->api, "MPIIO") == 0)
             && (test->blockSize < sizeof(IOR_size_t)
@@ -1658,6 +1738,8 @@ static void ValidateTests(IOR_param_t * test, MPI_Comm com)
                 ERR("file-per-proc not available in current NCMPI");
 
         backend = test->backend;
+        if (test->threadsPerRank > 1 && ! backend->thread_safe)
+                ERRF("API %s does not support multiple threads per rank", test->api);
         ior_set_xfer_hints(test);
         /* allow the backend to validate the options */
         if(test->backend->check_params){
@@ -1696,88 +1778,70 @@ static int init_random_seed(IOR_param_t * test, int pretendRank){
 }
 
 /**
- * Returns a precomputed array of IOR_offset_t for the inner benchmark loop.
- * They get created sequentially and mixed up in the end.
- * It should be noted that as the seeds get synchronised across all processes if not FilePerProcess is set
- * every process computes the same random order.
- * For a shared file all transfers get randomly assigned to ranks. The processes
- * can also have differen't numbers of transfers. This might lead to a bigger
- * diversion in accesse as it dose with filePerProc. This is expected but
- * should be mined.
+ * Prepares the shuffled (-z) access of a task and returns the number of
+ * transfers of the task per segment.
+ * The transfers of a block are visited in the order of a pseudo-random
+ * permutation that is computed on the fly, see TransferOffset().
+ * For a shared file, the seed is synchronized across all processes and the
+ * permutation covers the transfers of all tasks in a segment; task r
+ * accesses the entries [r * transfers, (r+1) * transfers) of it, hence every
+ * transfer of the file is accessed by exactly one task.
  * @param test IOR_param_t for getting transferSize, blocksize and SegmentCount
- * @param pretendRank int pretended Rank for shifting the offsets correctly
- * @return IOR_offset_t
+ * @param pretendRank int pretended Rank for seeding a file per process
+ * @param perm the permutation to initialize
+ * @return number of transfers of this task per segment
  */
-IOR_offset_t *GetOffsetArrayRandom(IOR_param_t * test, int pretendRank, IOR_offset_t * out_count)
+static IOR_offset_t GetOffsetShuffle(IOR_param_t * test, int pretendRank, random_permutation_t * perm)
 {
-        int seed;
-        IOR_offset_t i;
-        IOR_offset_t offsets;
-        IOR_offset_t offsetCnt = 0;
-        IOR_offset_t *offsetArray;
-
-        seed = init_random_seed(test, pretendRank);
+        int seed = init_random_seed(test, pretendRank);
+        IOR_offset_t transfers = test->blockSize / test->transferSize;
 
-        /* count needed offsets (pass 1) */
         if (test->filePerProc) {
-          offsets = test->blockSize / test->transferSize;
-        }else{
-          offsets = 0;
-          for (i = 0; i < test->blockSize * test->numTasks; i += test->transferSize) {
-            // this counts which process get how many transferes in the shared file
-            if ((rand() % test->numTasks) == pretendRank) {
-              offsets++;
-            }
-          }
-        }
-
-        /* setup empty array */
-        offsetArray = (IOR_offset_t *) safeMalloc(offsets * sizeof(IOR_offset_t));
-
-        *out_count = offsets;
-
-        if (test->filePerProc) {
-            /* fill array */
-            for (i = 0; i < offsets; i++) {
-                offsetArray[i] = i * test->transferSize;
-            }
+                random_permutation_init(perm, transfers, (unsigned) seed);
         } else {
-            /* fill with offsets (pass 2) */
-            srandom(seed);  /* need same seed to get same transfers as counted in the beginning*/
-            for (i = 0; i < test->blockSize * test->numTasks; i += test->transferSize) {
-                if ((rand() % test->numTasks) == pretendRank) {
-                    offsetArray[offsetCnt] = i;
-                    offsetCnt++;
-                }
-            }
-        }
-        /* reorder array */
-        for (i = 0; i < offsets; i++) {
-                IOR_offset_t value, tmp;
-                value = rand() % offsets;
-                tmp = offsetArray[value];
-                offsetArray[value] = offsetArray[i];
-                offsetArray[i] = tmp;
+                random_permutation_init(perm, transfers * test->numTasks, (unsigned) seed);
         }
+        return transfers;
+}
+
+/* record the latency of an operation on offset/size that started at start */
+static void RecordLatency(OpTimer *ot, latency_histogram_t *hist, double startTime, double start, IOR_offset_t offset, IOR_offset_t size)
+{
+        double now = GetTimeStamp();
+        if (ot)
+                OpTimerRecord(ot, start - startTime, now - start, offset, size);
+        if (hist)
+                latency_histogram_add(hist, now - start);
+}
 
-        return (offsetArray);
+/*
+ * Busy loop simulating computation, unlike interIODelay it keeps the core
+ * busy so that only the MPI library or the kernel progress the I/O.
+ */
+static void ComputeOverlap(int us)
+{
+        double end = GetTimeStamp() + us * 1e-6;
+        while (GetTimeStamp() < end)
+                ;
 }
 
-static IOR_offset_t WriteOrReadSingle(IOR_offset_t offset, int pretendRank, IOR_offset_t transfer, int * errors, IOR_param_t * test, aiori_fd_t * fd, IOR_io_buffers* ioBuffers, int access, OpTimer* ot, double startTime){
+static IOR_offset_t WriteOrReadSingle(IOR_offset_t offset, int pretendRank, IOR_offset_t transfer, int * errors, IOR_param_t * test, aiori_fd_t * fd, IOR_io_buffers* ioBuffers, int access, OpTimer* ot, latency_histogram_t* hist, double startTime){
   IOR_offset_t amtXferred = 0;
 
   void *buffer = ioBuffers->buffer;
   if (access == WRITE) {
           /* fills each transfer with a unique pattern
            * containing the offset into the file */
-          update_write_memory_pattern(offset, ioBuffers->buffer, transfer, test->setTimeStampSignature, pretendRank, test->dataPacketType, test->gpuMemoryFlags);
+          update_write_memory_pattern(offset, ioBuffers->buffer, transfer, test->timeStampSignatureValue, pretendRank, test->dataPacketType, test->gpuMemoryFlags);
           double start = GetTimeStamp();
           amtXferred = backend->xfer(access, fd, buffer, transfer, offset, test->backend_options);
-          if(ot) OpTimerValue(ot, start - startTime, GetTimeStamp() - start);
+          RecordLatency(ot, hist, startTime, start, offset, transfer);
           if (amtXferred != transfer)
                   ERR("cannot write to file");
           if (test->fsyncPerWrite)
                 backend->fsync(fd, test->backend_options);
+          if (test->computeOverlapUs > 0)
+                ComputeOverlap(test->computeOverlapUs);
           if (test->interIODelay > 0){
             struct timespec wait = {test->interIODelay / 1000 / 1000, 1000l * (test->interIODelay % 1000000)};
             nanosleep( & wait, NULL);
@@ -1785,9 +1849,11 @@ static IOR_offset_t WriteOrReadSingle(IOR_offset_t offset, int pretendRank, IOR_
   } else if (access == READ) {
           double start = GetTimeStamp();
           amtXferred = backend->xfer(access, fd, buffer, transfer, offset, test->backend_options);
-          if(ot) OpTimerValue(ot, start - startTime, GetTimeStamp() - start);
+          RecordLatency(ot, hist, startTime, start, offset, transfer);
           if (amtXferred != transfer)
                   ERR("cannot read from file");
+          if (test->computeOverlapUs > 0)
+                ComputeOverlap(test->computeOverlapUs);
           if (test->interIODelay > 0){
             struct timespec wait = {test->interIODelay / 1000 / 1000, 1000l * (test->interIODelay % 1000000)};
             nanosleep( & wait, NULL);
@@ -1796,7 +1862,7 @@ static IOR_offset_t WriteOrReadSingle(IOR_offset_t offset, int pretendRank, IOR_
           invalidate_buffer_pattern(buffer, transfer, test->gpuMemoryFlags);
           double start = GetTimeStamp();
           amtXferred = backend->xfer(access, fd, buffer, transfer, offset, test->backend_options);
-          if(ot) OpTimerValue(ot, start - startTime, GetTimeStamp() - start);
+          RecordLatency(ot, hist, startTime, start, offset, transfer);
           if (amtXferred != transfer)
                   ERR("cannot read from file write check");
           *errors += CompareData(buffer, transfer, test, offset, pretendRank, WRITECHECK);
@@ -1804,7 +1870,7 @@ static IOR_offset_t WriteOrReadSingle(IOR_offset_t offset, int pretendRank, IOR_
           invalidate_buffer_pattern(buffer, transfer, test->gpuMemoryFlags);          
           double start = GetTimeStamp();
           amtXferred = backend->xfer(access, fd, buffer, transfer, offset, test->backend_options);
-          if(ot) OpTimerValue(ot, start - startTime, GetTimeStamp() - start);
+          RecordLatency(ot, hist, startTime, start, offset, transfer);
           if (amtXferred != transfer){
             ERR("cannot read from file");
           }
@@ -1827,12 +1893,294 @@ static void prefillSegment(IOR_param_t *test, void * randomPrefillBuffer, int pr
       } else {
         offset += (i * test->numTasks * test->blockSize) + (pretendRank * test->blockSize);
       }
-      WriteOrReadSingle(offset, pretendRank, test->randomPrefillBlocksize, & errors, test, fd, ioBuffers, WRITE, NULL, 0);
+      WriteOrReadSingle(offset, pretendRank, test->randomPrefillBlocksize, & errors, test, fd, ioBuffers, WRITE, NULL, NULL, 0);
     }
   }
   ioBuffers->buffer = oldBuffer;
 }
 
+/* offset of transfer j in segment i for sequential and shuffled (-z) access */
+static IOR_offset_t TransferOffset(IOR_param_t *test, const random_permutation_t *shuffle, int pretendRank, IOR_offset_t i, IOR_offset_t j)
+{
+        if (test->randomOffset == 1) {
+                IOR_offset_t transfers = test->blockSize / test->transferSize;
+                if (test->filePerProc)
+                        return random_permutation_get(shuffle, j) * test->transferSize + (i * test->blockSize);
+                return random_permutation_get(shuffle, pretendRank * transfers + j) * test->transferSize + (i * test->numTasks * test->blockSize);
+        }
+        if (test->filePerProc)
+                return j * test->transferSize + i * test->blockSize;
+        return j * test->transferSize + (i * test->numTasks * test->blockSize) + (pretendRank * test->blockSize);
+}
+
+/*
+ * Transfer pipeline used for asynchronous backends and a queue depth > 1.
+ * The buffers of the IOR_io_buffers ring are handed to the backend
+ * round-robin, a buffer is reused only once its request has completed.
+ * Backends without the asynchronous interface complete every request
+ * synchronously upon submission.
+ */
+typedef struct {
+        aiori_xfer_req_t req;
+        double start;
+        int busy;
+} xfer_slot_t;
+
+typedef struct {
+        IOR_param_t *test;
+        aiori_fd_t *fd;
+        int access;
+        int pretendRank;
+        OpTimer *ot;
+        latency_histogram_t *hist;
+        double startTime;
+        int depth;
+        int in_flight;
+        int next;
+        int async;
+        xfer_slot_t *slots;
+        aiori_xfer_req_t **completed;
+        int errors;
+        IOR_offset_t dataMoved;
+} xfer_pipeline_t;
+
+static void PipelineInit(xfer_pipeline_t *p, IOR_param_t *test, aiori_fd_t *fd, int access, int pretendRank, OpTimer *ot, latency_histogram_t *hist, double startTime, IOR_io_buffers *ioBuffers)
+{
+        memset(p, 0, sizeof(xfer_pipeline_t));
+        p->test = test;
+        p->fd = fd;
+        p->access = access;
+        p->pretendRank = pretendRank;
+        p->ot = ot;
+        p->hist = hist;
+        p->startTime = startTime;
+        p->depth = ioBuffers->ringSize;
+        p->async = backend->xfer_submit && backend->xfer_poll && backend->xfer_wait;
+        p->slots = safeMalloc(sizeof(xfer_slot_t) * p->depth);
+        p->completed = safeMalloc(sizeof(aiori_xfer_req_t *) * p->depth);
+        memset(p->slots, 0, sizeof(xfer_slot_t) * p->depth);
+        for (int i = 0; i < p->depth; i++) {
+                p->slots[i].req.buffer = ioBuffers->ring[i];
+                p->slots[i].req.user_data = & p->slots[i];
+        }
+}
+
+static void PipelineComplete(xfer_pipeline_t *p, aiori_xfer_req_t *req)
+{
+        IOR_param_t *test = p->test;
+        xfer_slot_t *slot = (xfer_slot_t *) req->user_data;
+
+        RecordLatency(p->ot, p->hist, p->startTime, slot->start, req->offset, req->length);
+        if (req->transferred != req->length) {
+                if (req->access == WRITE)
+                        ERR("cannot write to file");
+                else if (req->access == WRITECHECK)
+                        ERR("cannot read from file write check");
+                else
+                        ERR("cannot read from file");
+        }
+        if (req->access == WRITE && test->fsyncPerWrite)
+                backend->fsync(p->fd, test->backend_options);
+        if (req->access == WRITECHECK || req->access == READCHECK)
+                p->errors += CompareData(req->buffer, req->length, test, req->offset, p->pretendRank, req->access);
+        p->dataMoved += req->transferred;
+        p->in_flight--;
+        slot->busy = 0;
+}
+
+/* reap completed requests, blocks until at least min requests completed */
+static void PipelineReap(xfer_pipeline_t *p, int min)
+{
+        int count;
+
+        if (p->in_flight == 0)
+                return;
+        if (min > 0)
+                count = backend->xfer_wait(p->fd, p->completed, min, p->in_flight, p->test->backend_options);
+        else
+                count = backend->xfer_poll(p->fd, p->completed, p->in_flight, p->test->backend_options);
+        if (count < min)
+                ERRF("%s: waiting for %d transfers returned %d", backend->name, min, count);
+        for (int i = 0; i < count; i++)
+                PipelineComplete(p, p->completed[i]);
+}
+
+static void PipelineSubmit(xfer_pipeline_t *p, IOR_offset_t offset, IOR_offset_t transfer)
+{
+        IOR_param_t *test = p->test;
+        xfer_slot_t *slot;
+        aiori_xfer_req_t *req;
+
+        slot = &p->slots[p->next];
+        while (slot->busy)
+                PipelineReap(p, 1);
+        p->next = (p->next + 1) % p->depth;
+        req = &slot->req;
+        req->access = p->access;
+        req->length = transfer;
+        req->offset = offset;
+        req->transferred = 0;
+
+        if (p->access == WRITE) {
+                update_write_memory_pattern(offset, (char *) req->buffer, transfer, test->timeStampSignatureValue, p->pretendRank, test->dataPacketType, test->gpuMemoryFlags);
+        } else if (p->access == WRITECHECK || p->access == READCHECK) {
+                invalidate_buffer_pattern((char *) req->buffer, transfer, test->gpuMemoryFlags);
+        }
+        p->in_flight++;
+        slot->busy = 1;
+        slot->start = GetTimeStamp();
+        if (p->async) {
+                if (backend->xfer_submit(p->fd, req, test->backend_options) != 0)
+                        ERRF("%s: cannot submit transfer at offset %lld", backend->name, (long long) offset);
+                if ((p->access == WRITE || p->access == READ) && test->computeOverlapUs > 0)
+                        ComputeOverlap(test->computeOverlapUs);
+                PipelineReap(p, 0);
+        } else {
+                req->transferred = backend->xfer(req->access, p->fd, req->buffer, transfer, offset, test->backend_options);
+                PipelineComplete(p, req);
+                if ((p->access == WRITE || p->access == READ) && test->computeOverlapUs > 0)
+                        ComputeOverlap(test->computeOverlapUs);
+        }
+        if ((p->access == WRITE || p->access == READ) && test->interIODelay > 0) {
+                struct timespec wait = {test->interIODelay / 1000 / 1000, 1000l * (test->interIODelay % 1000000)};
+                nanosleep( & wait, NULL);
+        }
+}
+
+/* wait for all requests in flight and hand over the accumulated results */
+static void PipelineDrain(xfer_pipeline_t *p, IOR_offset_t *dataMoved, int *errors)
+{
+        while (p->in_flight > 0)
+                PipelineReap(p, p->in_flight);
+        *dataMoved += p->dataMoved;
+        *errors += p->errors;
+        p->dataMoved = 0;
+        p->errors = 0;
+}
+
+static void PipelineFree(xfer_pipeline_t *p)
+{
+        free(p->slots);
+        free(p->completed);
+}
+
+/*
+ * Multiple threads per task: thread t issues the transfers t, t + N, t + 2N, ...
+ * of every block, using its own transfer buffers and operation timer.
+ */
+typedef struct {
+        IOR_param_t *test;
+        aiori_fd_t *fd;
+        int access;
+        int id;
+        int pretendRank;
+        IOR_offset_t offsets;
+        const random_permutation_t *shuffle;
+        IOR_io_buffers ioBuffers;
+        OpTimer *ot;
+        latency_histogram_t *hist;     /* NULL or latency */
+        latency_histogram_t latency;
+        double startTime;
+        IOR_offset_t dataMoved;
+        int errors;
+        uint64_t pairCnt;
+        pthread_t thread;
+} xfer_thread_t;
+
+static void *XferThread(void *arg)
+{
+        xfer_thread_t *t = (xfer_thread_t *) arg;
+        IOR_param_t *test = t->test;
+        int hitStonewall = 0;
+        xfer_pipeline_t pipeline;
+        xfer_pipeline_t *pipe = NULL;
+
+        if (t->ioBuffers.ringSize > 1 || backend->xfer_submit){
+          pipe = & pipeline;
+          PipelineInit(pipe, test, t->fd, t->access, t->pretendRank, t->ot, t->hist, t->startTime, & t->ioBuffers);
+        }
+        do{
+          for (IOR_offset_t i = 0; i < test->segmentCount && !hitStonewall; i++) {
+            for (IOR_offset_t j = t->id; j < t->offsets && !hitStonewall; j += test->threadsPerRank) {
+              IOR_offset_t offset = TransferOffset(test, t->shuffle, t->pretendRank, i, j);
+              if (pipe)
+                PipelineSubmit(pipe, offset, test->transferSize);
+              else
+                t->dataMoved += WriteOrReadSingle(offset, t->pretendRank, test->transferSize, & t->errors, test, t->fd, & t->ioBuffers, t->access, t->ot, t->hist, t->startTime);
+              t->pairCnt++;
+              hitStonewall = test->deadlineForStonewalling != 0
+                  && (GetTimeStamp() - t->startTime) > test->deadlineForStonewalling;
+            }
+          }
+        } while((GetTimeStamp() - t->startTime) < test->minTimeDuration);
+        if (pipe){
+          PipelineDrain(pipe, & t->dataMoved, & t->errors);
+          PipelineFree(pipe);
+        }
+        return NULL;
+}
+
+/* run the transfers of this task with test->threadsPerRank threads and sum up their results */
+static IOR_offset_t WriteOrReadThreaded(IOR_param_t *test, int rep, IOR_point_t *point, latency_histogram_t *hist, aiori_fd_t *fd, const int access,
+                                        IOR_io_buffers *ioBuffers, int pretendRank, IOR_offset_t offsets, const random_permutation_t *shuffle)
+{
+        int threads = test->threadsPerRank;
+        xfer_thread_t *thread = safeMalloc(sizeof(xfer_thread_t) * threads);
+        IOR_offset_t dataMoved = 0;
+        uint64_t pairCnt = 0;
+        int errors = 0;
+        double startTime;
+
+        memset(thread, 0, sizeof(xfer_thread_t) * threads);
+        for (int t = 0; t < threads; t++) {
+                xfer_thread_t *x = & thread[t];
+                x->test = test;
+                x->fd = fd;
+                x->access = access;
+                x->id = t;
+                x->pretendRank = pretendRank;
+                x->offsets = offsets;
+                x->shuffle = shuffle;
+                x->hist = hist ? & x->latency : NULL;
+                x->ioBuffers.ringSize = test->queueDepth;
+                x->ioBuffers.ring = ioBuffers->ring + t * test->queueDepth;
+                x->ioBuffers.buffer = x->ioBuffers.ring[0];
+                if(test->savePerOpDataCSV != NULL) {
+                        char fname[FILENAME_MAX];
+                        sprintf(fname, "%s-%d-%05d-%03d.optrace", test->savePerOpDataCSV, rep, rank, t);
+                        x->ot = OpTimerInit(fname, test->transferSize);
+                }
+        }
+        startTime = GetTimeStamp();
+        for (int t = 0; t < threads; t++) {
+                thread[t].startTime = startTime;
+                int ret = pthread_create(& thread[t].thread, NULL, XferThread, & thread[t]);
+                if (ret != 0)
+                        ERRF("cannot create transfer thread %d: %s", t, strerror(ret));
+        }
+        for (int t = 0; t < threads; t++) {
+                pthread_join(thread[t].thread, NULL);
+                dataMoved += thread[t].dataMoved;
+                errors += thread[t].errors;
+                pairCnt += thread[t].pairCnt;
+                if (hist)
+                        latency_histogram_merge(hist, & thread[t].latency);
+                OpTimerFree(& thread[t].ot);
+        }
+        free(thread);
+        if (verbose >= VERBOSE_2){
+          fprintf(out_logfile, "%d: %d threads accessed %lld pairs\n", rank, threads, (long long) pairCnt);
+        }
+        point->pairs_accessed = pairCnt;
+
+        totalErrorCount += CountErrors(test, access, errors);
+
+        if (access == WRITE && test->fsync == TRUE) {
+                backend->fsync(fd, test->backend_options);       /*fsync after all accesses */
+        }
+        return (dataMoved);
+}
+
 /*
  * Write or Read data to file(s).  This loops through the strides, writing
  * out the data to each block in transfer sizes, until the remainder left is 0.
@@ -1849,6 +2197,8 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
         IOR_offset_t i, j;
         IOR_point_t *point = ((access == WRITE) || (access == WRITECHECK)) ?
                              &results->write : &results->read;
+        /* the verification after the write phase is not timed */
+        latency_histogram_t *hist = access == WRITECHECK ? NULL : & point->xfer_latency;
 
         /* initialize values */
         pretendRank = (rank + rankOffset) % test->numTasks;
@@ -1856,9 +2206,9 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
         //  offsetArray = GetOffsetArraySequential(test, pretendRank);
 
         IOR_offset_t offsets;
-        IOR_offset_t * offsets_rnd;
+        random_permutation_t shuffle;
         if (test->randomOffset == 1) {
-          offsets_rnd = GetOffsetArrayRandom(test, pretendRank, & offsets);
+          offsets = GetOffsetShuffle(test, pretendRank, & shuffle);
         }else{
           offsets = (test->blockSize / test->transferSize);
         }
@@ -1866,6 +2216,8 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
           int seed = init_random_seed(test, pretendRank);
           srand(seed + pretendRank);
         }
+        if (test->threadsPerRank > 1)
+          return WriteOrReadThreaded(test, rep, point, hist, fd, access, ioBuffers, pretendRank, offsets, & shuffle);
 
         void * randomPrefillBuffer = NULL;
         if(test->randomPrefillBlocksize && (access == WRITE || access == WRITECHECK)){
@@ -1878,13 +2230,20 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
         OpTimer * ot = NULL;
         if(test->savePerOpDataCSV != NULL) {
                 char fname[FILENAME_MAX];
-                sprintf(fname, "%s-%d-%05d.csv", test->savePerOpDataCSV, rep, rank);
+                sprintf(fname, "%s-%d-%05d.optrace", test->savePerOpDataCSV, rep, rank);
                 ot = OpTimerInit(fname, test->transferSize);
         }
         // start timer after random offset was generated        
         startForStonewall = GetTimeStamp();
         hitStonewall = 0;
 
+        xfer_pipeline_t pipeline;
+        xfer_pipeline_t *pipe = NULL;
+        if (ioBuffers->ringSize > 1 || backend->xfer_submit){
+          pipe = & pipeline;
+          PipelineInit(pipe, test, fd, access, pretendRank, ot, hist, startForStonewall, ioBuffers);
+        }
+
         if(randomPrefillBuffer && test->deadlineForStonewalling == 0){
           double t_start = GetTimeStamp();
           prefillSegment(test, randomPrefillBuffer, pretendRank, fd, ioBuffers, 0, test->segmentCount);
@@ -1919,23 +2278,15 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
                 }
             }
             for (j = 0; j < offsets &&  !hitStonewall ; j++) {
-              if (test->randomOffset == 1) {
-                if(test->filePerProc){
-                  offset = offsets_rnd[j] + (i * test->blockSize);
-                }else{
-                  offset = offsets_rnd[j] + (i * test->numTasks * test->blockSize);
-                }
-              }else if (test->randomOffset > 1){
+              if (test->randomOffset > 1){
                 offset += test->transferSize;
               }else{
-                offset = j * test->transferSize;
-                if (test->filePerProc) {
-                  offset += i * test->blockSize;
-                } else {
-                  offset += (i * test->numTasks * test->blockSize) + (pretendRank * test->blockSize);
-                }
+                offset = TransferOffset(test, & shuffle, pretendRank, i, j);
               }
-              dataMoved += WriteOrReadSingle(offset, pretendRank, test->transferSize, & errors, test, fd, ioBuffers, access, ot, startForStonewall);
+              if (pipe)
+                PipelineSubmit(pipe, offset, test->transferSize);
+              else
+                dataMoved += WriteOrReadSingle(offset, pretendRank, test->transferSize, & errors, test, fd, ioBuffers, access, ot, hist, startForStonewall);
               pairCnt++;
 
               hitStonewall = ((test->deadlineForStonewalling != 0
@@ -1950,6 +2301,8 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
             }
           }
         } while((GetTimeStamp() - startForStonewall) < test->minTimeDuration);
+        if (pipe)
+          PipelineDrain(pipe, & dataMoved, & errors);
         if (test->stoneWallingWearOut){
           if (verbose >= VERBOSE_1){
             fprintf(out_logfile, "%d: stonewalling pairs accessed: %lld\n", rank, (long long) pairCnt);
@@ -1991,23 +2344,15 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
                   offset = rand() % (sizerand / test->blockSize) * test->blockSize - test->transferSize;
               }
               for ( ; j < offsets && pairCnt < point->pairs_accessed ; j++) {
-                if (test->randomOffset == 1) {
-                  if(test->filePerProc){
-                    offset = offsets_rnd[j] + (i * test->blockSize);
-                  }else{
-                    offset = offsets_rnd[j] + (i * test->numTasks * test->blockSize);
-                  }
-                }else if (test->randomOffset > 1){
+                if (test->randomOffset > 1){
                   offset += test->transferSize;
                 }else{
-                  offset = j * test->transferSize;
-                  if (test->filePerProc) {
-                    offset += i * test->blockSize;
-                  } else {
-                    offset += (i * test->numTasks * test->blockSize) + (pretendRank * test->blockSize);
-                  }
+                  offset = TransferOffset(test, & shuffle, pretendRank, i, j);
                 }
-                dataMoved += WriteOrReadSingle(offset, pretendRank, test->transferSize, & errors, test, fd, ioBuffers, access, ot, startForStonewall);
+                if (pipe)
+                  PipelineSubmit(pipe, offset, test->transferSize);
+                else
+                  dataMoved += WriteOrReadSingle(offset, pretendRank, test->transferSize, & errors, test, fd, ioBuffers, access, ot, hist, startForStonewall);
                 pairCnt++;
               }
               j = 0;              
@@ -2016,6 +2361,10 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
         }else{
           point->pairs_accessed = pairCnt;
         }
+        if (pipe){
+          PipelineDrain(pipe, & dataMoved, & errors);
+          PipelineFree(pipe);
+        }
 
         OpTimerFree(& ot);
         totalErrorCount += CountErrors(test, access, errors);
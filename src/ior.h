@@ -34,6 +34,7 @@
 #include "option.h"
 #include "iordef.h"
 #include "aiori.h"
+#include "histogram.h"
 
 #include <mpi.h>
 
@@ -55,6 +56,8 @@ typedef struct IO_BUFFERS
     void* buffer;
     void* checkBuffer;
     void* readCheckBuffer;
+    void** ring;          /* queueDepth transfer buffers per thread, ring[0] == buffer */
+    int ringSize;
 
 } IOR_io_buffers;
 
@@ -100,6 +103,7 @@ typedef struct
     int multiFile;                   /* multiple files */
     int interTestDelay;              /* delay between reps in seconds */
     int interIODelay;                /* delay after each I/O in us */
+    int computeOverlapUs;            /* computation after posting each I/O in us */
     int open;                        /* flag for writing or reading */
     int readFile;                    /* read of existing file */
     int writeFile;                   /* write of file */
@@ -118,6 +122,8 @@ typedef struct
     IOR_offset_t transferSize;       /* size of transfer in bytes */
     IOR_offset_t expectedAggFileSize; /* calculated aggregate file size */
     IOR_offset_t randomPrefillBlocksize;   /* prefill option for random IO, the amount of data used for prefill */
+    int queueDepth;                  /* number of transfers kept in flight per task, 0 for the backend default */
+    int threadsPerRank;              /* number of threads issuing transfers per task */
 
     char * savePerOpDataCSV;            /* save details about each I/O operation into this file */
     char * saveRankDetailsCSV;       /* save the details about the performance to a file */
@@ -174,6 +180,14 @@ typedef struct {
    IOR_offset_t aggFileSizeFromStat;
    IOR_offset_t aggFileSizeFromXfer;
    IOR_offset_t aggFileSizeForBW;
+
+   long long transfers;  /* of all tasks, counted by backends providing xfer_counts() */
+   long long syscalls;   /* data system calls issued for the transfers */
+
+   /* latencies of this task, merged across all tasks on rank 0 by ReduceIterResults() */
+   latency_histogram_t xfer_latency;
+   latency_histogram_t open_latency;
+   latency_histogram_t close_latency;
 } IOR_point_t;
 
 typedef struct {
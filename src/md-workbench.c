@@ -8,12 +8,14 @@
 #include <stdlib.h>
 #include <math.h>
 #include <assert.h>
+#include <pthread.h>
 
 #include "md-workbench.h"
 #include "config.h"
 #include "aiori.h"
 #include "utilities.h"
 #include "parse_options.h"
+#include "histogram.h"
 
 /*
 This is the modified version md-workbench-fs that can utilize AIORI.
@@ -55,12 +57,19 @@ typedef struct{ // NOTE: if this type is changed, adjust end_phase() !!!
   op_stat_t obj_delete;
 
   // time measurements of individual runs, these are not returned for now by the API!
+  // they are only kept for latency files and the exact statistics, NULL otherwise
   uint64_t repeats;
   time_result_t * time_create;
   time_result_t * time_read;
   time_result_t * time_stat;
   time_result_t * time_delete;
 
+  // latency distribution of all operations, merged across processes for the statistics
+  latency_histogram_t hist_create;
+  latency_histogram_t hist_read;
+  latency_histogram_t hist_stat;
+  latency_histogram_t hist_delete;
+
   time_statistics_t stats_create;
   time_statistics_t stats_read;
   time_statistics_t stats_stat;
@@ -101,6 +110,8 @@ struct benchmark_options{
 
   char * latency_file_prefix;
   int latency_keep_all;
+  int latency_exact;
+  int latency_precision;
 
   int phase_cleanup;
   int phase_precreate;
@@ -128,6 +139,7 @@ struct benchmark_options{
   int adaptive_waiting_mode;
 
   uint64_t start_item_number;
+  int concurrency; // cycles in flight per rank during the benchmark phase, using a pool of threads
 };
 
 struct benchmark_options o;
@@ -154,6 +166,7 @@ void init_options(){
   .packetTypeStr = "t",
   .run_info_file = "md-workbench.status",
   .gpuID = -1,
+  .latency_precision = LATENCY_HISTOGRAM_SUB_BITS,
   };
 }
 
@@ -176,21 +189,37 @@ static void mdw_wait(double runtime){
   }
 }
 
-static void init_stats(phase_stat_t * p, size_t repeats){
+// keep_times: the number of time_result_t to store for each operation type
+static void init_stats(phase_stat_t * p, size_t repeats, size_t keep_times){
   memset(p, 0, sizeof(phase_stat_t));
   p->repeats = repeats;
-  size_t timer_size = repeats * sizeof(time_result_t);
+  latency_histogram_reset(& p->hist_create);
+  latency_histogram_reset(& p->hist_read);
+  latency_histogram_reset(& p->hist_stat);
+  latency_histogram_reset(& p->hist_delete);
+  if(keep_times == 0){
+    return;
+  }
+  size_t timer_size = keep_times * sizeof(time_result_t);
   p->time_create = (time_result_t *) malloc(timer_size);
   p->time_read = (time_result_t *) malloc(timer_size);
   p->time_stat = (time_result_t *) malloc(timer_size);
   p->time_delete = (time_result_t *) malloc(timer_size);
 }
 
-static float add_timed_result(double start, double phase_start_timer, time_result_t * results, size_t pos, double * max_time, double * out_op_time){
+// the times of each operation of a process are only needed for latency files and exact statistics
+static size_t times_to_keep(size_t repeats){
+  return (o.latency_exact || o.latency_file_prefix) ? repeats : 0;
+}
+
+static float add_timed_result(double start, double phase_start_timer, latency_histogram_t * hist, time_result_t * results, size_t pos, double * max_time, double * out_op_time){
   float curtime = start - phase_start_timer;
   double op_time = GetTimeStamp() - start;
-  results[pos].runtime = (float) op_time;
-  results[pos].time_since_app_start = curtime;
+  latency_histogram_add(hist, op_time);
+  if(results){
+    results[pos].runtime = (float) op_time;
+    results[pos].time_since_app_start = curtime;
+  }
   if (op_time > *max_time){
     *max_time = op_time;
   }
@@ -414,6 +443,44 @@ static void compute_histogram(const char * name, time_result_t * times, time_sta
   stats->max = times[repeats - 1].runtime;
 }
 
+static void histogram_statistics(const latency_histogram_t * hist, time_statistics_t * stats){
+  stats->min = latency_histogram_min(hist);
+  stats->q1 = latency_histogram_quantile(hist, 0.25);
+  stats->median = latency_histogram_quantile(hist, 0.5);
+  stats->q3 = latency_histogram_quantile(hist, 0.75);
+  stats->q90 = latency_histogram_quantile(hist, 0.90);
+  stats->q99 = latency_histogram_quantile(hist, 0.99);
+  stats->max = latency_histogram_max(hist);
+}
+
+/*
+ * Compute the statistics of one operation type of this process and of all processes on rank 0.
+ * By default, the latency histograms are merged by a reduction, otherwise all times are sent to rank 0.
+ */
+static void reduce_timers(const char * name, uint64_t repeats, int max_repeats, time_result_t * times, time_result_t * global_times, latency_histogram_t * hist, latency_histogram_t * global_hist, time_statistics_t * stats, time_statistics_t * global_stats){
+  char name_all[MAX_PATHLEN];
+  int write_rank0_latency_file = (o.rank == 0) && ! o.latency_keep_all;
+  sprintf(name_all, "%s-all", name);
+
+  if(o.latency_exact){
+    uint64_t count = aggregate_timers(repeats, max_repeats, times, global_times);
+    if(o.rank == 0){
+      compute_histogram(name_all, global_times, global_stats, count, o.latency_keep_all);
+    }
+  }else{
+    memcpy(global_hist, hist, sizeof(latency_histogram_t));
+    latency_histogram_reduce(global_hist, 0, o.com);
+    if(o.rank == 0){
+      histogram_statistics(global_hist, global_stats);
+    }
+  }
+  if(times){
+    compute_histogram(name, times, stats, repeats, write_rank0_latency_file);
+  }else{
+    histogram_statistics(hist, stats);
+  }
+}
+
 static void end_phase(const char * name, phase_stat_t * p){
   int ret;
   char buff[MAX_PATHLEN];
@@ -428,7 +495,7 @@ static void end_phase(const char * name, phase_stat_t * p){
 
   // prepare the summarized report
   phase_stat_t g_stat;
-  init_stats(& g_stat, (o.rank == 0 ? 1 : 0) * ((size_t) max_repeats) * o.size);
+  init_stats(& g_stat, (o.rank == 0 ? 1 : 0) * ((size_t) max_repeats) * o.size, (o.rank == 0 && o.latency_exact) ? ((size_t) max_repeats) * o.size : 0);
   // reduce timers
   ret = MPI_Reduce(& p->t, & g_stat.t, 2, MPI_DOUBLE, MPI_MAX, 0, o.com);
   CHECK_MPI_RET(ret)
@@ -446,45 +513,16 @@ static void end_phase(const char * name, phase_stat_t * p){
     CHECK_MPI_RET(ret)
     g_stat.stonewall_iterations = p->stonewall_iterations;
   }
-  int write_rank0_latency_file = (o.rank == 0) && ! o.latency_keep_all;
-
   if(strcmp(name,"precreate") == 0){
-    uint64_t repeats = aggregate_timers(p->repeats, max_repeats, p->time_create, g_stat.time_create);
-    if(o.rank == 0){
-      compute_histogram("precreate-all", g_stat.time_create, & g_stat.stats_create, repeats, o.latency_keep_all);
-    }
-    compute_histogram("precreate", p->time_create, & p->stats_create, p->repeats, write_rank0_latency_file);
+    reduce_timers("precreate", p->repeats, max_repeats, p->time_create, g_stat.time_create, & p->hist_create, & g_stat.hist_create, & p->stats_create, & g_stat.stats_create);
   }else if(strcmp(name,"cleanup") == 0){
-    uint64_t repeats = aggregate_timers(p->repeats, max_repeats, p->time_delete, g_stat.time_delete);
-    if(o.rank == 0) {
-      compute_histogram("cleanup-all", g_stat.time_delete, & g_stat.stats_delete, repeats, o.latency_keep_all);
-    }
-    compute_histogram("cleanup", p->time_delete, & p->stats_delete, p->repeats, write_rank0_latency_file);
+    reduce_timers("cleanup", p->repeats, max_repeats, p->time_delete, g_stat.time_delete, & p->hist_delete, & g_stat.hist_delete, & p->stats_delete, & g_stat.stats_delete);
   }else if(strcmp(name,"benchmark") == 0){
-    uint64_t repeats = aggregate_timers(p->repeats, max_repeats, p->time_read, g_stat.time_read);
-    if(o.rank == 0) {
-      compute_histogram("read-all", g_stat.time_read, & g_stat.stats_read, repeats, o.latency_keep_all);
-    }
-    compute_histogram("read", p->time_read, & p->stats_read, p->repeats, write_rank0_latency_file);
-
-    repeats = aggregate_timers(p->repeats, max_repeats, p->time_stat, g_stat.time_stat);
-    if(o.rank == 0) {
-      compute_histogram("stat-all", g_stat.time_stat, & g_stat.stats_stat, repeats, o.latency_keep_all);
-    }
-    compute_histogram("stat", p->time_stat, & p->stats_stat, p->repeats, write_rank0_latency_file);
-
+    reduce_timers("read", p->repeats, max_repeats, p->time_read, g_stat.time_read, & p->hist_read, & g_stat.hist_read, & p->stats_read, & g_stat.stats_read);
+    reduce_timers("stat", p->repeats, max_repeats, p->time_stat, g_stat.time_stat, & p->hist_stat, & g_stat.hist_stat, & p->stats_stat, & g_stat.stats_stat);
     if(! o.read_only){
-      repeats = aggregate_timers(p->repeats, max_repeats, p->time_create, g_stat.time_create);
-      if(o.rank == 0) {
-        compute_histogram("create-all", g_stat.time_create, & g_stat.stats_create, repeats, o.latency_keep_all);
-      }
-      compute_histogram("create", p->time_create, & p->stats_create, p->repeats, write_rank0_latency_file);
-
-      repeats = aggregate_timers(p->repeats, max_repeats, p->time_delete, g_stat.time_delete);
-      if(o.rank == 0) {
-        compute_histogram("delete-all", g_stat.time_delete, & g_stat.stats_delete, repeats, o.latency_keep_all);
-      }
-      compute_histogram("delete", p->time_delete, & p->stats_delete, p->repeats, write_rank0_latency_file);
+      reduce_timers("create", p->repeats, max_repeats, p->time_create, g_stat.time_create, & p->hist_create, & g_stat.hist_create, & p->stats_create, & g_stat.stats_create);
+      reduce_timers("delete", p->repeats, max_repeats, p->time_delete, g_stat.time_delete, & p->hist_delete, & g_stat.hist_delete, & p->stats_delete, & g_stat.stats_delete);
     }
   }
 
@@ -588,7 +626,7 @@ void run_precreate(phase_stat_t * s, int current_index){
       }
       o.backend->close(aiori_fh, o.backend_options);
 
-      add_timed_result(op_timer, s->phase_start_timer, s->time_create, pos, & s->max_op_time, & op_time);
+      add_timed_result(op_timer, s->phase_start_timer, & s->hist_create, s->time_create, pos, & s->max_op_time, & op_time);
 
       if (o.verbosity >= 2){
         oprintf("%d: write %s:%s (%d) pretend: %d\n", o.rank, dset, obj_name, ret, o.rank);
@@ -598,133 +636,300 @@ void run_precreate(phase_stat_t * s, int current_index){
   aligned_buffer_free(buf, o.gpuMemoryFlags);
 }
 
-/* FIFO: create a new file, write to it. Then read from the first created file, delete it... */
-void run_benchmark(phase_stat_t * s, int * current_index_p){
+/*
+ * One step of the FIFO for data set d: stat and read the oldest object prevFile,
+ * delete it, then create the newest object.  The counters, histograms, and
+ * maximum are accounted in acc, the individual times at pos in s.
+ * Returns the time since the phase start of the last operation.
+ */
+static float run_cycle(phase_stat_t * s, phase_stat_t * acc, char * buf, int prevFile, int d, size_t pos){
   char obj_name[MAX_PATHLEN];
   int ret;
-  char * buf = aligned_buffer_alloc(o.file_size, o.gpuMemoryFlags);
-  invalidate_buffer_pattern(buf, o.file_size, o.gpuMemoryFlags);
   double op_timer; // timer for individual operations
-  size_t pos = -1; // position inside the individual measurement array
-  int start_index = *current_index_p;
-  int total_num = o.num;
-  int armed_stone_wall = (o.stonewall_timer > 0);
-  int f;
-  double phase_allreduce_time = 0;
+  double op_time;
+  float bench_runtime;
+  struct stat stat_buf;
   aiori_fd_t * aiori_fh;
 
-  for(f=0; f < total_num; f++){
-    float bench_runtime = 0; // the time since start
-    for(int d=0; d < o.dset_count; d++){
-      double op_time;
-      struct stat stat_buf;
-      const int prevFile = f + start_index;
-      pos++;
+  int readRank = (o.rank - o.offset * (d+1)) % o.size;
+  readRank = readRank < 0 ? readRank + o.size : readRank;
+  def_obj_name(obj_name, readRank, d, prevFile);
 
-      int readRank = (o.rank - o.offset * (d+1)) % o.size;
-      readRank = readRank < 0 ? readRank + o.size : readRank;
-      def_obj_name(obj_name, readRank, d, prevFile);
+  op_timer = GetTimeStamp();
 
-      op_timer = GetTimeStamp();
+  ret = o.backend->stat(obj_name, & stat_buf, o.backend_options);
+  // TODO potentially check return value must be identical to o.file_size
 
-      ret = o.backend->stat(obj_name, & stat_buf, o.backend_options);
-      // TODO potentially check return value must be identical to o.file_size
-
-      bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_stat, pos, & s->max_op_time, & op_time);
-      if(o.relative_waiting_factor > 1e-9) {
-        mdw_wait(op_time);
-      }
+  bench_runtime = add_timed_result(op_timer, s->phase_start_timer, & acc->hist_stat, s->time_stat, pos, & acc->max_op_time, & op_time);
+  if(o.relative_waiting_factor > 1e-9) {
+    mdw_wait(op_time);
+  }
 
-      if (o.verbosity >= 2){
-        oprintf("%d: stat %s (%d)\n", o.rank, obj_name, ret);
-      }
+  if (o.verbosity >= 2){
+    oprintf("%d: stat %s (%d)\n", o.rank, obj_name, ret);
+  }
 
-      if(ret != 0){
-        if (o.verbosity)
-          ERRF("%d: Error while stating the obj: %s", o.rank, obj_name);
-        s->obj_stat.err++;
-        continue;
-      }
-      s->obj_stat.suc++;
+  if(ret != 0){
+    if (o.verbosity)
+      ERRF("%d: Error while stating the obj: %s", o.rank, obj_name);
+    acc->obj_stat.err++;
+    return bench_runtime;
+  }
+  acc->obj_stat.suc++;
 
-      if (o.verbosity >= 2){
-        oprintf("%d: read %s pretend: %d\n", o.rank, obj_name, readRank);
-      }
+  if (o.verbosity >= 2){
+    oprintf("%d: read %s pretend: %d\n", o.rank, obj_name, readRank);
+  }
 
-      op_timer = GetTimeStamp();
-      aiori_fh = o.backend->open(obj_name, IOR_RDONLY, o.backend_options);
-      if (NULL == aiori_fh){
-        FAIL("Unable to open file %s", obj_name);
-      }
-      if ( o.file_size == (int) o.backend->xfer(READ, aiori_fh, (IOR_size_t *) buf, o.file_size, 0, o.backend_options) ) {
-        if(o.verify_read){
-            if(verify_memory_pattern(prevFile * o.dset_count + d, buf, o.file_size, o.random_seed, readRank, o.dataPacketType, o.gpuMemoryFlags) == 0){
-              s->obj_read.suc++;
-            }else{
-              s->obj_read.err++;
-            }
+  op_timer = GetTimeStamp();
+  aiori_fh = o.backend->open(obj_name, IOR_RDONLY, o.backend_options);
+  if (NULL == aiori_fh){
+    FAIL("Unable to open file %s", obj_name);
+  }
+  if ( o.file_size == (int) o.backend->xfer(READ, aiori_fh, (IOR_size_t *) buf, o.file_size, 0, o.backend_options) ) {
+    if(o.verify_read){
+        if(verify_memory_pattern(prevFile * o.dset_count + d, buf, o.file_size, o.random_seed, readRank, o.dataPacketType, o.gpuMemoryFlags) == 0){
+          acc->obj_read.suc++;
         }else{
-          s->obj_read.suc++;
+          acc->obj_read.err++;
         }
-      }else{
-        s->obj_read.err++;
-        WARNF("%d: Error while reading the obj: %s", o.rank, obj_name);
-      }
-      o.backend->close(aiori_fh, o.backend_options);
+    }else{
+      acc->obj_read.suc++;
+    }
+  }else{
+    acc->obj_read.err++;
+    WARNF("%d: Error while reading the obj: %s", o.rank, obj_name);
+  }
+  o.backend->close(aiori_fh, o.backend_options);
 
-      bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_read, pos, & s->max_op_time, & op_time);
-      if(o.relative_waiting_factor > 1e-9) {
-        mdw_wait(op_time);
-      }
-      if(o.read_only){
-        continue;
-      }
+  bench_runtime = add_timed_result(op_timer, s->phase_start_timer, & acc->hist_read, s->time_read, pos, & acc->max_op_time, & op_time);
+  if(o.relative_waiting_factor > 1e-9) {
+    mdw_wait(op_time);
+  }
+  if(o.read_only){
+    return bench_runtime;
+  }
 
-      op_timer = GetTimeStamp();
-      o.backend->remove(obj_name, o.backend_options);
-      bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_delete, pos, & s->max_op_time, & op_time);
-      if(o.relative_waiting_factor > 1e-9) {
-        mdw_wait(op_time);
-      }
+  op_timer = GetTimeStamp();
+  o.backend->remove(obj_name, o.backend_options);
+  bench_runtime = add_timed_result(op_timer, s->phase_start_timer, & acc->hist_delete, s->time_delete, pos, & acc->max_op_time, & op_time);
+  if(o.relative_waiting_factor > 1e-9) {
+    mdw_wait(op_time);
+  }
 
-      if (o.verbosity >= 2){
-        oprintf("%d: delete %s\n", o.rank, obj_name);
-      }
-      s->obj_delete.suc++;
+  if (o.verbosity >= 2){
+    oprintf("%d: delete %s\n", o.rank, obj_name);
+  }
+  acc->obj_delete.suc++;
 
-      int writeRank = (o.rank + o.offset * (d+1)) % o.size;
-      const int newFileIndex = o.precreate + prevFile;
-      def_obj_name(obj_name, writeRank, d, newFileIndex);
+  int writeRank = (o.rank + o.offset * (d+1)) % o.size;
+  const int newFileIndex = o.precreate + prevFile;
+  def_obj_name(obj_name, writeRank, d, newFileIndex);
 
-      op_timer = GetTimeStamp();
-      aiori_fh = o.backend->create(obj_name, IOR_WRONLY | IOR_CREAT, o.backend_options);
-      if (NULL != aiori_fh){
-        generate_memory_pattern(buf, o.file_size, o.random_seed, writeRank, o.dataPacketType, o.gpuMemoryFlags);
-        update_write_memory_pattern(newFileIndex * o.dset_count + d, buf, o.file_size, o.random_seed, writeRank, o.dataPacketType, o.gpuMemoryFlags);
-        
-        if ( o.file_size == (int) o.backend->xfer(WRITE, aiori_fh, (IOR_size_t *) buf, o.file_size, 0, o.backend_options)) {
-          s->obj_create.suc++;
-        }else{
-          s->obj_create.err++;
-          if (! o.ignore_precreate_errors){
-            ERRF("%d: Error while creating the obj: %s\n", o.rank, obj_name);
-          }
-        }
-        o.backend->close(aiori_fh, o.backend_options);
-      }else{
-        if (! o.ignore_precreate_errors){
-         ERRF("%d: Error while creating the obj: %s", o.rank, obj_name);
-        }
-        WARNF("Unable to open file %s", obj_name);
-        s->obj_create.err++;
-      }
-      bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_create, pos, & s->max_op_time, & op_time);
-      if(o.relative_waiting_factor > 1e-9) {
-        mdw_wait(op_time);
+  op_timer = GetTimeStamp();
+  aiori_fh = o.backend->create(obj_name, IOR_WRONLY | IOR_CREAT, o.backend_options);
+  if (NULL != aiori_fh){
+    generate_memory_pattern(buf, o.file_size, o.random_seed, writeRank, o.dataPacketType, o.gpuMemoryFlags);
+    update_write_memory_pattern(newFileIndex * o.dset_count + d, buf, o.file_size, o.random_seed, writeRank, o.dataPacketType, o.gpuMemoryFlags);
+    
+    if ( o.file_size == (int) o.backend->xfer(WRITE, aiori_fh, (IOR_size_t *) buf, o.file_size, 0, o.backend_options)) {
+      acc->obj_create.suc++;
+    }else{
+      acc->obj_create.err++;
+      if (! o.ignore_precreate_errors){
+        ERRF("%d: Error while creating the obj: %s\n", o.rank, obj_name);
       }
+    }
+    o.backend->close(aiori_fh, o.backend_options);
+  }else{
+    if (! o.ignore_precreate_errors){
+     ERRF("%d: Error while creating the obj: %s", o.rank, obj_name);
+    }
+    WARNF("Unable to open file %s", obj_name);
+    acc->obj_create.err++;
+  }
+  bench_runtime = add_timed_result(op_timer, s->phase_start_timer, & acc->hist_create, s->time_create, pos, & acc->max_op_time, & op_time);
+  if(o.relative_waiting_factor > 1e-9) {
+    mdw_wait(op_time);
+  }
 
-      if (o.verbosity >= 2){
-        oprintf("%d: write %s (%d) pretend: %d\n", o.rank, obj_name, ret, writeRank);
+  if (o.verbosity >= 2){
+    oprintf("%d: write %s (%d) pretend: %d\n", o.rank, obj_name, ret, writeRank);
+  }
+  return bench_runtime;
+}
+
+/*
+ * Worker threads for --concurrency, each rank keeps up to o.concurrency
+ * cycles of run_cycle() in flight.  The cycles are submitted in the FIFO
+ * order of the serial benchmark, only their operations overlap.  Every worker
+ * accounts into its own phase_stat_t that is merged into the phase at the end.
+ */
+typedef struct{
+  int prevFile;
+  int d;
+  size_t pos;
+} mdw_cycle_t;
+
+typedef struct{
+  pthread_t thread;
+  phase_stat_t stat;
+  char * buf;
+} mdw_worker_t;
+
+typedef struct{
+  mdw_worker_t * workers;
+  mdw_cycle_t * queue;   /* ring buffer of o.concurrency cycles */
+  int head;
+  int queued;
+  int active;            /* cycles being processed */
+  int shutdown;
+  phase_stat_t * s;      /* the current phase */
+  pthread_mutex_t lock;
+  pthread_cond_t work;   /* signaled once a cycle is queued */
+  pthread_cond_t done;   /* signaled once a cycle is processed */
+} mdw_pool_t;
+
+static mdw_pool_t mdw_pool;
+
+static void * mdw_worker(void * arg){
+  mdw_worker_t * w = (mdw_worker_t *) arg;
+  pthread_mutex_lock(& mdw_pool.lock);
+  while(1){
+    while(mdw_pool.queued == 0 && ! mdw_pool.shutdown){
+      pthread_cond_wait(& mdw_pool.work, & mdw_pool.lock);
+    }
+    if(mdw_pool.queued == 0){
+      break;
+    }
+    mdw_cycle_t c = mdw_pool.queue[mdw_pool.head];
+    mdw_pool.head = (mdw_pool.head + 1) % o.concurrency;
+    mdw_pool.queued--;
+    mdw_pool.active++;
+    pthread_mutex_unlock(& mdw_pool.lock);
+
+    run_cycle(mdw_pool.s, & w->stat, w->buf, c.prevFile, c.d, c.pos);
+
+    pthread_mutex_lock(& mdw_pool.lock);
+    mdw_pool.active--;
+    pthread_cond_broadcast(& mdw_pool.done);
+  }
+  pthread_mutex_unlock(& mdw_pool.lock);
+  return NULL;
+}
+
+static void mdw_pool_init(){
+  memset(& mdw_pool, 0, sizeof(mdw_pool));
+  pthread_mutex_init(& mdw_pool.lock, NULL);
+  pthread_cond_init(& mdw_pool.work, NULL);
+  pthread_cond_init(& mdw_pool.done, NULL);
+  mdw_pool.queue = safeMalloc(sizeof(mdw_cycle_t) * o.concurrency);
+  mdw_pool.workers = safeMalloc(sizeof(mdw_worker_t) * o.concurrency);
+  for(int i = 0; i < o.concurrency; i++){
+    mdw_worker_t * w = & mdw_pool.workers[i];
+    w->buf = aligned_buffer_alloc(o.file_size, o.gpuMemoryFlags);
+    invalidate_buffer_pattern(w->buf, o.file_size, o.gpuMemoryFlags);
+    if (pthread_create(& w->thread, NULL, mdw_worker, w) != 0) {
+      FAIL("Unable to create worker thread %d", i);
+    }
+  }
+}
+
+static void mdw_pool_free(){
+  pthread_mutex_lock(& mdw_pool.lock);
+  mdw_pool.shutdown = 1;
+  pthread_cond_broadcast(& mdw_pool.work);
+  pthread_mutex_unlock(& mdw_pool.lock);
+  for(int i = 0; i < o.concurrency; i++){
+    pthread_join(mdw_pool.workers[i].thread, NULL);
+    aligned_buffer_free(mdw_pool.workers[i].buf, o.gpuMemoryFlags);
+  }
+  free(mdw_pool.workers);
+  free(mdw_pool.queue);
+  pthread_mutex_destroy(& mdw_pool.lock);
+  pthread_cond_destroy(& mdw_pool.work);
+  pthread_cond_destroy(& mdw_pool.done);
+}
+
+static void mdw_pool_start(phase_stat_t * s){
+  mdw_pool.s = s;
+  for(int i = 0; i < o.concurrency; i++){
+    init_stats(& mdw_pool.workers[i].stat, 0, 0);
+  }
+}
+
+/* queues the cycle, waits while o.concurrency cycles are in flight */
+static void mdw_pool_submit(int prevFile, int d, size_t pos){
+  pthread_mutex_lock(& mdw_pool.lock);
+  while(mdw_pool.queued + mdw_pool.active >= o.concurrency){
+    pthread_cond_wait(& mdw_pool.done, & mdw_pool.lock);
+  }
+  int tail = (mdw_pool.head + mdw_pool.queued) % o.concurrency;
+  mdw_pool.queue[tail] = (mdw_cycle_t){.prevFile = prevFile, .d = d, .pos = pos};
+  mdw_pool.queued++;
+  pthread_cond_signal(& mdw_pool.work);
+  pthread_mutex_unlock(& mdw_pool.lock);
+}
+
+static void mdw_pool_drain(){
+  pthread_mutex_lock(& mdw_pool.lock);
+  while(mdw_pool.queued + mdw_pool.active > 0){
+    pthread_cond_wait(& mdw_pool.done, & mdw_pool.lock);
+  }
+  pthread_mutex_unlock(& mdw_pool.lock);
+}
+
+static void add_op_stat(op_stat_t * dst, const op_stat_t * src){
+  dst->suc += src->suc;
+  dst->err += src->err;
+}
+
+/* waits for the cycles in flight and adds the statistics of the workers to s */
+static void mdw_pool_finish(phase_stat_t * s){
+  mdw_pool_drain();
+  for(int i = 0; i < o.concurrency; i++){
+    phase_stat_t * p = & mdw_pool.workers[i].stat;
+    add_op_stat(& s->obj_create, & p->obj_create);
+    add_op_stat(& s->obj_read, & p->obj_read);
+    add_op_stat(& s->obj_stat, & p->obj_stat);
+    add_op_stat(& s->obj_delete, & p->obj_delete);
+    latency_histogram_merge(& s->hist_create, & p->hist_create);
+    latency_histogram_merge(& s->hist_read, & p->hist_read);
+    latency_histogram_merge(& s->hist_stat, & p->hist_stat);
+    latency_histogram_merge(& s->hist_delete, & p->hist_delete);
+    if(p->max_op_time > s->max_op_time){
+      s->max_op_time = p->max_op_time;
+    }
+  }
+}
+
+/* FIFO: create a new file, write to it. Then read from the first created file, delete it... */
+void run_benchmark(phase_stat_t * s, int * current_index_p){
+  char * buf = NULL;
+  size_t pos = -1; // position inside the individual measurement array
+  int start_index = *current_index_p;
+  int total_num = o.num;
+  int armed_stone_wall = (o.stonewall_timer > 0);
+  int f;
+  double phase_allreduce_time = 0;
+
+  if(o.concurrency > 1){
+    mdw_pool_start(s);
+  }else{
+    buf = aligned_buffer_alloc(o.file_size, o.gpuMemoryFlags);
+    invalidate_buffer_pattern(buf, o.file_size, o.gpuMemoryFlags);
+  }
+
+  for(f=0; f < total_num; f++){
+    float bench_runtime = 0; // the time since start
+    for(int d=0; d < o.dset_count; d++){
+      const int prevFile = f + start_index;
+      pos++;
+      if(o.concurrency > 1){
+        mdw_pool_submit(prevFile, d, pos);
+        bench_runtime = GetTimeStamp() - s->phase_start_timer;
+      }else{
+        bench_runtime = run_cycle(s, s, buf, prevFile, d, pos);
       }
     } // end loop
 
@@ -737,6 +942,10 @@ void run_benchmark(phase_stat_t * s, int * current_index_p){
         break;
       }
       armed_stone_wall = 0;
+      if(o.concurrency > 1){
+        // the phase timer is restarted below
+        mdw_pool_drain();
+      }
       // wear out mode, now reduce the maximum
       int cur_pos = f + 1;
       phase_allreduce_time = GetTimeStamp() - s->phase_start_timer;
@@ -752,6 +961,9 @@ void run_benchmark(phase_stat_t * s, int * current_index_p){
       }
     }
   }
+  if(o.concurrency > 1){
+    mdw_pool_finish(s);
+  }
   s->t = GetTimeStamp() - s->phase_start_timer + phase_allreduce_time;
   if(armed_stone_wall && o.stonewall_timer_wear_out){
     int f = total_num;
@@ -770,7 +982,9 @@ void run_benchmark(phase_stat_t * s, int * current_index_p){
     *current_index_p += f;
   }
   s->repeats = pos + 1;
-  aligned_buffer_free(buf, o.gpuMemoryFlags);
+  if(buf){
+    aligned_buffer_free(buf, o.gpuMemoryFlags);
+  }
 }
 
 void run_cleanup(phase_stat_t * s, int start_index){
@@ -787,7 +1001,7 @@ void run_cleanup(phase_stat_t * s, int start_index){
 
       op_timer = GetTimeStamp();
       o.backend->remove(obj_name, o.backend_options);
-      add_timed_result(op_timer, s->phase_start_timer, s->time_delete, pos, & s->max_op_time, & op_time);
+      add_timed_result(op_timer, s->phase_start_timer, & s->hist_delete, s->time_delete, pos, & s->max_op_time, & op_time);
 
       if (o.verbosity >= 2){
         oprintf("%d: delete %s\n", o.rank, obj_name);
@@ -814,6 +1028,8 @@ static option_help options [] = {
   {'I', "obj-per-proc", "Number of I/O operations per data set.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.num},
   {'L', "latency", "Measure the latency for individual operations, prefix the result files with the provided filename.", OPTION_OPTIONAL_ARGUMENT, 's', & o.latency_file_prefix},
   {0, "latency-all", "Keep the latency files from all ranks.", OPTION_FLAG, 'd', & o.latency_keep_all},
+  {0, "latency-exact", "Gather the latency of all operations on rank 0 to compute exact statistics, by default the merged histograms are off by at most 2^-N of --latency-precision.", OPTION_FLAG, 'd', & o.latency_exact},
+  {0, "latency-precision", "Split every power of two of the latency histograms into 2^N buckets, the quantiles are then off by at most 2^-N.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.latency_precision},
   {'P', "precreate-per-set", "Number of object to precreate per data set.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.precreate},
   {'D', "data-sets", "Number of data sets covered per process and iteration.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.dset_count},
   {'G', NULL,        "Timestamp/Random seed for access pattern, if not set, a random value is used", OPTION_OPTIONAL_ARGUMENT, 'd', & o.random_seed},
@@ -831,7 +1047,7 @@ static option_help options [] = {
   {'w', "stonewall-timer", "Stop each benchmark iteration after the specified seconds (if not used with -W this leads to process-specific progress!)", OPTION_OPTIONAL_ARGUMENT, 'd', & o.stonewall_timer},
   {'W', "stonewall-wear-out", "Stop with stonewall after specified time and use a soft wear-out phase -- all processes perform the same number of iterations", OPTION_FLAG, 'd', & o.stonewall_timer_wear_out},
   {'X', "verify-read", "Verify the data on read", OPTION_FLAG, 'd', & o.verify_read},
-  {0, "dataPacketType", "type of packet that will be created [offset|incompressible|timestamp|random|o|i|t|r]", OPTION_OPTIONAL_ARGUMENT, 's', & o.packetTypeStr},
+  {0, "dataPacketType", "type of packet that will be created [offset|incompressible|timestamp|random|compressible|o|i|t|r|c]", OPTION_OPTIONAL_ARGUMENT, 's', & o.packetTypeStr},
 #ifdef HAVE_CUDA
   {0, "allocateBufferOnGPU", "Allocate I/O buffers on the GPU: X=1 uses managed memory - verifications are run on CPU; X=2 managed memory - verifications on GPU; X=3 device memory with verifications on GPU.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.gpuMemoryFlags},
   {0, "GPUid", "Select the GPU to use, use -1 for round-robin among local procs.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.gpuID},
@@ -839,6 +1055,7 @@ static option_help options [] = {
   {0, "gpuDirect", "Allocate I/O buffers on the GPU and use gpuDirect to store data; this option is incompatible with any option requiring CPU access to data.", OPTION_FLAG, 'd', & o.gpuDirect},
 #endif
 #endif
+  {0, "concurrency", "Number of stat/read/delete/create cycles each process keeps in flight during the benchmark phase using a pool of threads, requires a thread-safe API", OPTION_OPTIONAL_ARGUMENT, 'd', & o.concurrency},
   {0, "start-item", "The iteration number of the item to start with, allowing to offset the operations", OPTION_OPTIONAL_ARGUMENT, 'l', & o.start_item_number},
   {0, "print-detailed-stats", "Print detailed machine parsable statistics.", OPTION_FLAG, 'd', & o.print_detailed_stats},
   {0, "read-only", "Run read-only during benchmarking phase (no deletes/writes), probably use with -2", OPTION_FLAG, 'd', & o.read_only},
@@ -922,6 +1139,10 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
       ERR("Backend doesn't support MDWorbench");
   }
   o.backend_options = airoi_update_module_options(o.backend, global_options);
+  if (o.concurrency > 1 && ! o.backend->thread_safe){
+      ERR("--concurrency requires a thread-safe API");
+  }
+  latency_histogram_set_precision(o.latency_precision);
   
   o.dataPacketType = parsePacketType(o.packetTypeStr[0]);
 
@@ -973,6 +1194,9 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
     if(o.num > o.precreate){
       oprintf("WARNING: num > precreate, this may cause the situation that no objects are available to read\n");
     }
+    if(o.concurrency > o.precreate * o.dset_count){
+      oprintf("WARNING: concurrency > precreate * data-sets, objects may be read while they are created\n");
+    }
   }
 
   if ( o.rank == 0 && ! o.quiet_output ){
@@ -1006,7 +1230,7 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
           WARNF("Unable to create test directory %s", o.prefix);
       }
     }
-    init_stats(& phase_stats, o.precreate * o.dset_count);
+    init_stats(& phase_stats, o.precreate * o.dset_count, times_to_keep(o.precreate * o.dset_count));
     MPI_Barrier(o.com);
 
     // pre-creation phase
@@ -1017,12 +1241,15 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
   }
 
   if (o.phase_benchmark){
+    if(o.concurrency > 1){
+      mdw_pool_init();
+    }
     // benchmark phase
     for(o.global_iteration = 0; o.global_iteration < o.iterations; o.global_iteration++){
       if(o.adaptive_waiting_mode){
         o.relative_waiting_factor = 0;
       }
-      init_stats(& phase_stats, o.num * o.dset_count);
+      init_stats(& phase_stats, o.num * o.dset_count, times_to_keep(o.num * o.dset_count));
       MPI_Barrier(o.com);
       phase_stats.phase_start_timer = GetTimeStamp();
       run_benchmark(& phase_stats, & current_index);
@@ -1031,7 +1258,7 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
       if(o.adaptive_waiting_mode){
         o.relative_waiting_factor = 0.0625;
         for(int r=0; r <= 6; r++){
-          init_stats(& phase_stats, o.num * o.dset_count);
+          init_stats(& phase_stats, o.num * o.dset_count, times_to_keep(o.num * o.dset_count));
           MPI_Barrier(o.com);
           phase_stats.phase_start_timer = GetTimeStamp();
           run_benchmark(& phase_stats, & current_index);
@@ -1040,11 +1267,14 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
         }
       }
     }
+    if(o.concurrency > 1){
+      mdw_pool_free();
+    }
   }
 
   // cleanup phase
   if (o.phase_cleanup){
-    init_stats(& phase_stats, o.precreate * o.dset_count);
+    init_stats(& phase_stats, o.precreate * o.dset_count, times_to_keep(o.precreate * o.dset_count));
     phase_stats.phase_start_timer = GetTimeStamp();
     run_cleanup(& phase_stats, current_index);
     phase_stats.t = GetTimeStamp() - phase_stats.phase_start_timer;
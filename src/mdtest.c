@@ -37,6 +37,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <stdarg.h>
+#include <pthread.h>
 
 #include "option.h"
 #include "utilities.h"
@@ -100,7 +101,7 @@
 
 typedef struct {
   int size;
-  uint64_t *rand_array;
+  random_permutation_t rand_perm; /* order of the items for -R */
   char testdir[MAX_PATHLEN];
   char testdirpath[MAX_PATHLEN];
   char base_tree_name[MAX_PATHLEN];
@@ -166,6 +167,9 @@ typedef struct {
   int unique_dir_per_task;
   int time_unique_dir_overhead;
   int collective_creates;
+  int collective_aggregators; /* tasks doing the collective creates */
+  int md_concurrency; /* metadata operations in flight per task, using a pool of threads */
+  int md_batch;       /* items per bulk metadata call */
   size_t write_bytes;
   int stone_wall_timer_seconds;
   size_t read_bytes;
@@ -211,6 +215,284 @@ typedef struct{
 
 #define CHECK_STONE_WALL(p) (((p)->stone_wall_timer_seconds != 0) && ((GetTimeStamp() - (p)->start_time) > (p)->stone_wall_timer_seconds))
 
+/*
+ * Item names are assembled without formatting: "<path>/" and the item prefix,
+ * e.g., "file.<name>", are copied once per phase and the item number is
+ * appended with utoa().  Items addressed by their number in the whole tree
+ * keep the directory part of the last item, consecutive items of a directory
+ * reuse it and only the walk to the tree root of a new directory is done.
+ */
+typedef struct{
+  char buf[MAX_PATHLEN];
+  int base_len;         /* length of "<path>/" */
+  char item[MAX_PATHLEN];
+  int item_len;
+  uint64_t item_offset; /* added to the item numbers in the tree, for leaf only mode */
+  uint64_t dir;         /* directory of the cached prefix, UINT64_MAX if none */
+  int dir_len;          /* length of "<path>/<tree directories of dir>/" */
+} item_path_t;
+
+/* writes the decimal number v to out, returns the terminating NUL */
+static char * utoa(uint64_t v, char * out){
+  char digits[20];
+  int n = 0;
+  do{
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  }while(v);
+  while(n){
+    *out++ = digits[--n];
+  }
+  *out = 0;
+  return out;
+}
+
+static void item_path_init(item_path_t * p, const char * path, const char * kind, const char * name){
+  p->base_len = snprintf(p->buf, MAX_PATHLEN, "%s/", path);
+  p->item_len = snprintf(p->item, MAX_PATHLEN, "%s%s", kind, name);
+  if(p->base_len + p->item_len + 21 > MAX_PATHLEN){
+    FAIL("path %s/%s%s is too long", path, kind, name);
+  }
+  p->item_offset = 0;
+  if (o.leaf_only) {
+    p->item_offset = o.items_per_dir * (o.num_dirs_in_tree - (uint64_t) pow(o.branch_factor, o.depth));
+  }
+  p->dir = UINT64_MAX;
+  p->dir_len = p->base_len;
+}
+
+static char * item_path_append(item_path_t * p, int pos, uint64_t item_num){
+  memcpy(p->buf + pos, p->item, p->item_len);
+  utoa(item_num, p->buf + pos + p->item_len);
+  return p->buf;
+}
+
+/* name of the item item_num inside of path */
+static char * item_path_in_dir(item_path_t * p, uint64_t item_num){
+  return item_path_append(p, p->base_len, item_num);
+}
+
+/* path of the tree directory dir below path, ends with a '/' */
+static char * item_path_dir(item_path_t * p, uint64_t dir){
+  if(dir != p->dir){
+    /* assemble the directories from the leaf to the root at the end of the buffer */
+    int name_len = strlen(o.base_tree_name);
+    char * end = p->buf + MAX_PATHLEN;
+    char * pos = end;
+    char number[21];
+    for(uint64_t d = dir; d > 0; d = (d - 1) / o.branch_factor){
+      int len = utoa(d, number) - number;
+      if(pos - p->buf < p->base_len + name_len + len + 2 + p->item_len + 21){
+        FAIL("path of directory %" PRIu64 " is too long", dir);
+      }
+      *--pos = '/';
+      pos -= len;
+      memcpy(pos, number, len);
+      *--pos = '.';
+      pos -= name_len;
+      memcpy(pos, o.base_tree_name, name_len);
+      if(d <= o.branch_factor){
+        break;
+      }
+    }
+    memmove(p->buf + p->base_len, pos, end - pos);
+    p->dir_len = p->base_len + (end - pos);
+    p->dir = dir;
+  }
+  p->buf[p->dir_len] = 0;
+  return p->buf;
+}
+
+/* name of the item item_num of the tree below path */
+static char * item_path_in_tree(item_path_t * p, uint64_t item_num){
+  item_path_dir(p, item_num / o.items_per_dir);
+  return item_path_append(p, p->dir_len, item_num);
+}
+
+/* the number of the i-th item accessed in the tree */
+static uint64_t item_number(uint64_t i, int random, const item_path_t * p){
+  uint64_t item_num = random ? random_permutation_get(& o.rand_perm, i) : i;
+  /* make adjustments if in leaf only mode*/
+  return item_num + p->item_offset;
+}
+
+/* the items of one call for --md-batch */
+typedef struct{
+  char ** paths;
+  struct stat * stats;
+  int * results;
+} md_bulk_t;
+
+static md_bulk_t md_bulk;
+
+static void md_bulk_init(){
+  md_bulk.paths = safeMalloc(sizeof(char *) * o.md_batch);
+  for(int i = 0; i < o.md_batch; i++){
+    md_bulk.paths[i] = safeMalloc(MAX_PATHLEN);
+  }
+  md_bulk.stats = safeMalloc(sizeof(struct stat) * o.md_batch);
+  md_bulk.results = safeMalloc(sizeof(int) * o.md_batch);
+}
+
+static void md_bulk_free(){
+  for(int i = 0; i < o.md_batch; i++){
+    free(md_bulk.paths[i]);
+  }
+  free(md_bulk.paths);
+  free(md_bulk.stats);
+  free(md_bulk.results);
+}
+
+/*
+ * Worker threads for --md-concurrency, each task keeps up to md_concurrency
+ * metadata operations in flight.  The items of a job are claimed in increasing
+ * order and every claimed item is processed, thus the processed items are
+ * always a prefix of the range, even if the stonewall stops the job early.
+ */
+typedef struct md_job md_job_t;
+
+struct md_job{
+  void (*fn)(md_job_t * job, uint64_t i, int worker, item_path_t * ip); /* process item i */
+  const char * kind;    /* "file." or "dir." */
+  const char * name;
+  rank_progress_t * progress;
+  int check_stonewall;
+  int dirs;
+  int create;
+  int random;
+  const char * path;
+  uint64_t itemNum;
+  uint64_t next; /* next item to claim */
+  uint64_t end;
+  int stopped;   /* set once the stonewall is hit */
+};
+
+typedef struct{
+  pthread_t * threads;
+  char ** write_buffers; /* per worker */
+  char ** read_buffers;  /* per worker */
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  pthread_mutex_t ot_lock;
+  md_job_t * job;
+  uint64_t generation;   /* incremented for every job */
+  int running;           /* workers that did not finish the current job */
+  int shutdown;
+} md_pool_t;
+
+static md_pool_t md_pool;
+
+/* record the runtime of an operation that started at start */
+static void record_op(rank_progress_t * progress, double start){
+  if(! progress->ot){
+    return;
+  }
+  double now = GetTimeStamp();
+  if(o.md_concurrency > 1){
+    pthread_mutex_lock(& md_pool.ot_lock);
+    OpTimerValue(progress->ot, start - progress->start_time, now - start);
+    pthread_mutex_unlock(& md_pool.ot_lock);
+  }else{
+    OpTimerValue(progress->ot, start - progress->start_time, now - start);
+  }
+}
+
+static void * md_worker(void * arg){
+  int worker = (int) (intptr_t) arg;
+  uint64_t generation = 0;
+  item_path_t ip;
+
+  pthread_mutex_lock(& md_pool.lock);
+  while(1){
+    while(md_pool.generation == generation && ! md_pool.shutdown){
+      pthread_cond_wait(& md_pool.cond, & md_pool.lock);
+    }
+    if(md_pool.shutdown){
+      break;
+    }
+    generation = md_pool.generation;
+    md_job_t * job = md_pool.job;
+    pthread_mutex_unlock(& md_pool.lock);
+    item_path_init(& ip, job->path, job->kind, job->name);
+
+    while(! __atomic_load_n(& job->stopped, __ATOMIC_RELAXED)){
+      uint64_t i = __atomic_fetch_add(& job->next, 1, __ATOMIC_RELAXED);
+      if(i >= job->end){
+        break;
+      }
+      job->fn(job, i, worker, & ip);
+      if(job->check_stonewall && CHECK_STONE_WALL(job->progress)){
+        __atomic_store_n(& job->stopped, 1, __ATOMIC_RELAXED);
+      }
+    }
+
+    pthread_mutex_lock(& md_pool.lock);
+    if(--md_pool.running == 0){
+      pthread_cond_broadcast(& md_pool.cond);
+    }
+  }
+  pthread_mutex_unlock(& md_pool.lock);
+  return NULL;
+}
+
+/* process the items job->next to job->end - 1 with all workers, returns the end of the processed items */
+static uint64_t md_run_job(md_job_t * job){
+  pthread_mutex_lock(& md_pool.lock);
+  md_pool.job = job;
+  md_pool.running = o.md_concurrency;
+  md_pool.generation++;
+  pthread_cond_broadcast(& md_pool.cond);
+  while(md_pool.running > 0){
+    pthread_cond_wait(& md_pool.cond, & md_pool.lock);
+  }
+  pthread_mutex_unlock(& md_pool.lock);
+  return job->next < job->end ? job->next : job->end;
+}
+
+static void md_pool_init(){
+  memset(& md_pool, 0, sizeof(md_pool));
+  pthread_mutex_init(& md_pool.lock, NULL);
+  pthread_mutex_init(& md_pool.ot_lock, NULL);
+  pthread_cond_init(& md_pool.cond, NULL);
+  md_pool.threads = safeMalloc(sizeof(pthread_t) * o.md_concurrency);
+  md_pool.write_buffers = safeMalloc(sizeof(char *) * o.md_concurrency);
+  md_pool.read_buffers = safeMalloc(sizeof(char *) * o.md_concurrency);
+  for(int i = 0; i < o.md_concurrency; i++){
+    if (o.write_bytes > 0) {
+      md_pool.write_buffers[i] = aligned_buffer_alloc(o.write_bytes, o.gpuMemoryFlags);
+      generate_memory_pattern(md_pool.write_buffers[i], o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
+    }
+    if (o.read_bytes > 0) {
+      md_pool.read_buffers[i] = aligned_buffer_alloc(o.read_bytes, o.gpuMemoryFlags);
+    }
+    if (pthread_create(& md_pool.threads[i], NULL, md_worker, (void *) (intptr_t) i) != 0) {
+      FAIL("unable to create worker thread %d", i);
+    }
+  }
+}
+
+static void md_pool_free(){
+  pthread_mutex_lock(& md_pool.lock);
+  md_pool.shutdown = 1;
+  pthread_cond_broadcast(& md_pool.cond);
+  pthread_mutex_unlock(& md_pool.lock);
+  for(int i = 0; i < o.md_concurrency; i++){
+    pthread_join(md_pool.threads[i], NULL);
+    if (o.write_bytes > 0) {
+      aligned_buffer_free(md_pool.write_buffers[i], o.gpuMemoryFlags);
+    }
+    if (o.read_bytes > 0) {
+      aligned_buffer_free(md_pool.read_buffers[i], o.gpuMemoryFlags);
+    }
+  }
+  free(md_pool.threads);
+  free(md_pool.write_buffers);
+  free(md_pool.read_buffers);
+  pthread_mutex_destroy(& md_pool.lock);
+  pthread_mutex_destroy(& md_pool.ot_lock);
+  pthread_cond_destroy(& md_pool.cond);
+}
+
 /* for making/removing unique directory && stating/deleting subdirectory */
 enum {MK_UNI_DIR, STAT_SUB_DIR, READ_SUB_DIR, RM_SUB_DIR, RM_UNI_DIR};
 
@@ -328,16 +610,13 @@ void unique_dir_access(int opt, char *to) {
     VERBOSE(1,-1,"Entering unique_dir_access, set it to %s", to );
 }
 
-static void create_remove_dirs (const char *path, bool create, uint64_t itemNum) {
-    char curr_item[MAX_PATHLEN];
+static void create_remove_dirs (char *curr_item, bool create, uint64_t itemNum) {
     const char *operation = create ? "create" : "remove";
 
     if ( (itemNum % ITEM_COUNT==0 && (itemNum != 0))) {
         VERBOSE(3,5,"dir: "LLU"", operation, itemNum);
     }
 
-    //create dirs
-    sprintf(curr_item, "%s/dir.%s%" PRIu64, path, create ? o.mk_name : o.rm_name, itemNum);
     VERBOSE(3,5,"create_remove_items_helper (dirs %s): curr_item is '%s'", operation, curr_item);
 
     if (create) {
@@ -351,15 +630,11 @@ static void create_remove_dirs (const char *path, bool create, uint64_t itemNum)
     }
 }
 
-static void remove_file (const char *path, uint64_t itemNum) {
-    char curr_item[MAX_PATHLEN];
-
+static void remove_file (char *curr_item, uint64_t itemNum) {
     if ( (itemNum % ITEM_COUNT==0 && (itemNum != 0))) {
         VERBOSE(3,5,"remove file: "LLU"\n", itemNum);
     }
 
-    //remove files
-    sprintf(curr_item, "%s/file.%s"LLU"", path, o.rm_name, itemNum);
     VERBOSE(3,5,"create_remove_items_helper (non-dirs remove): curr_item is '%s'", curr_item);
     if (!(o.shared_file && rank != 0)) {
         o.backend->remove (curr_item, o.backend_options);
@@ -367,16 +642,13 @@ static void remove_file (const char *path, uint64_t itemNum) {
 }
 
 
-static void create_file (const char *path, uint64_t itemNum) {
-    char curr_item[MAX_PATHLEN];
+static void create_file (char *curr_item, uint64_t itemNum, char *write_buffer) {
     aiori_fd_t *aiori_fh = NULL;
 
     if ( (itemNum % ITEM_COUNT==0 && (itemNum != 0))) {
         VERBOSE(3,5,"create file: "LLU"", itemNum);
     }
 
-    //create files
-    sprintf(curr_item, "%s/file.%s"LLU"", path, o.mk_name, itemNum);
     VERBOSE(3,5,"create_remove_items_helper (non-dirs create): curr_item is '%s'", curr_item);
 
     if (o.make_node) {
@@ -415,19 +687,19 @@ static void create_file (const char *path, uint64_t itemNum) {
         VERBOSE(3,5,"create_remove_items_helper: write..." );
 
         o.hints.fsyncPerWrite = o.sync_file;
-        update_write_memory_pattern(itemNum, o.write_buffer, o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
+        update_write_memory_pattern(itemNum, write_buffer, o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
 
-        if ( o.write_bytes != (size_t) o.backend->xfer(WRITE, aiori_fh, (IOR_size_t *) o.write_buffer, o.write_bytes, 0, o.backend_options)) {
+        if ( o.write_bytes != (size_t) o.backend->xfer(WRITE, aiori_fh, (IOR_size_t *) write_buffer, o.write_bytes, 0, o.backend_options)) {
             WARNF("unable to write file %s", curr_item);
         }
 
         if (o.verify_write) {
-            o.write_buffer[0] = 42;
-            if (o.write_bytes != (size_t) o.backend->xfer(READ, aiori_fh, (IOR_size_t *) o.write_buffer, o.write_bytes, 0, o.backend_options)) {
+            write_buffer[0] = 42;
+            if (o.write_bytes != (size_t) o.backend->xfer(READ, aiori_fh, (IOR_size_t *) write_buffer, o.write_bytes, 0, o.backend_options)) {
                 WARNF("unable to verify write (read/back) file %s", curr_item);
             }
-            int error = verify_memory_pattern(itemNum, o.write_buffer, o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
-            o.verification_error += error;
+            int error = verify_memory_pattern(itemNum, write_buffer, o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
+            __atomic_fetch_add(& o.verification_error, error, __ATOMIC_RELAXED);
             if(error){
                 VERBOSE(1,1,"verification error in file: %s", curr_item);
             }
@@ -438,23 +710,108 @@ static void create_file (const char *path, uint64_t itemNum) {
     o.backend->close (aiori_fh, o.backend_options);
 }
 
+static void create_remove_item(md_job_t * job, uint64_t i, int worker, item_path_t * ip) {
+    char *curr_item = item_path_in_dir(ip, job->itemNum + i);
+    if (job->dirs) {
+        create_remove_dirs (curr_item, job->create, job->itemNum + i);
+        return;
+    }
+    double start = GetTimeStamp();
+    if (job->create) {
+        create_file (curr_item, job->itemNum + i, md_pool.write_buffers[worker]);
+    } else {
+        remove_file (curr_item, job->itemNum + i);
+    }
+    record_op(job->progress, start);
+}
+
+/* creates or removes the files of a directory with bulk calls of up to md_batch items */
+static void create_remove_files_bulk(const int create, item_path_t * ip, uint64_t itemNum, rank_progress_t * progress) {
+    for (uint64_t i = progress->items_start; i < progress->items_per_dir ; ) {
+        int count = progress->items_per_dir - i < (uint64_t) o.md_batch ? (int) (progress->items_per_dir - i) : o.md_batch;
+        for (int k = 0; k < count; k++) {
+            strcpy(md_bulk.paths[k], item_path_in_dir(ip, itemNum + i + k));
+            VERBOSE(3,5,"create_remove_items_helper (bulk %s): curr_item is '%s'", create ? "create" : "remove", md_bulk.paths[k]);
+        }
+        double start = GetTimeStamp();
+        int errors = 0;
+        if (create) {
+            o.hints.filePerProc = ! o.shared_file;
+            errors = aiori_bulk_create(o.backend, md_bulk.paths, count, IOR_WRONLY | IOR_CREAT, md_bulk.results, o.backend_options);
+        } else if (!(o.shared_file && rank != 0)) {
+            errors = aiori_bulk_remove(o.backend, md_bulk.paths, count, md_bulk.results, o.backend_options);
+        }
+        for (int k = 0; errors && k < count; k++) {
+            if (md_bulk.results[k] != 0) {
+                WARNF("unable to %s file %s", create ? "create" : "remove", md_bulk.paths[k]);
+            }
+        }
+        for (int k = 0; k < count; k++) {
+            record_op(progress, start);
+        }
+        i += count;
+        if(CHECK_STONE_WALL(progress)){
+          if(progress->items_done == 0){
+            progress->items_done = i;
+          }
+          return;
+        }
+    }
+    progress->items_done = progress->items_per_dir;
+}
+
 /* helper for creating/removing items */
 void create_remove_items_helper(const int dirs, const int create, const char *path,
-                                uint64_t itemNum, rank_progress_t * progress) {
+                                uint64_t itemNum, const char *name, rank_progress_t * progress) {
 
     VERBOSE(1,-1,"Entering create_remove_items_helper on %s", path );
 
+    const char *kind = dirs ? "dir." : "file.";
+
+    if (o.md_concurrency > 1) {
+        md_job_t job = {
+          .fn = create_remove_item,
+          .kind = kind,
+          .name = name,
+          .progress = progress,
+          .check_stonewall = 1,
+          .dirs = dirs,
+          .create = create,
+          .path = path,
+          .itemNum = itemNum,
+          .next = progress->items_start,
+          .end = progress->items_per_dir
+        };
+        uint64_t done = md_run_job(& job);
+        if (job.stopped) {
+          if(progress->items_done == 0){
+            progress->items_done = done;
+          }
+          return;
+        }
+        progress->items_done = progress->items_per_dir;
+        return;
+    }
+
+    item_path_t ip;
+    item_path_init(& ip, path, kind, name);
+    /* creates with data, mknod or collective opens are done one by one */
+    if (o.md_batch > 1 && ! dirs && (! create || (o.write_bytes == 0 && ! o.make_node && ! o.collective_creates))) {
+        create_remove_files_bulk(create, & ip, itemNum, progress);
+        return;
+    }
     for (uint64_t i = progress->items_start; i < progress->items_per_dir ; ++i) {
+        char *curr_item = item_path_in_dir(& ip, itemNum + i);
         if (!dirs) {
             double start = GetTimeStamp();
             if (create) {
-                create_file (path, itemNum + i);
+                create_file (curr_item, itemNum + i, o.write_buffer);
             } else {
-                remove_file (path, itemNum + i);
+                remove_file (curr_item, itemNum + i);
             }
-            if(progress->ot) OpTimerValue(progress->ot, start - progress->start_time, GetTimeStamp() - start);
+            record_op(progress, start);
         } else {
-            create_remove_dirs (path, create, itemNum + i);
+            create_remove_dirs (curr_item, create, itemNum + i);
         }
         if(CHECK_STONE_WALL(progress)){
           if(progress->items_done == 0){
@@ -467,17 +824,18 @@ void create_remove_items_helper(const int dirs, const int create, const char *pa
 }
 
 /* helper function to do collective operations */
-void collective_helper(const int dirs, const int create, const char* path, uint64_t itemNum, rank_progress_t * progress) {
-    char curr_item[MAX_PATHLEN];
+void collective_helper(const int dirs, const int create, const char* path, uint64_t itemNum, const char *name, rank_progress_t * progress) {
+    item_path_t ip;
 
     VERBOSE(1,-1,"Entering collective_helper on %s", path );
+    item_path_init(& ip, path, dirs ? "dir." : "file.", name);
     for (uint64_t i = progress->items_start ; i < progress->items_per_dir ; ++i) {
+        char *curr_item = item_path_in_dir(& ip, itemNum + i);
         if (dirs) {
-            create_remove_dirs (path, create, itemNum + i);
+            create_remove_dirs (curr_item, create, itemNum + i);
             continue;
         }
 
-        sprintf(curr_item, "%s/file.%s"LLU"", path, create ? o.mk_name : o.rm_name, itemNum+i);
         VERBOSE(3,5,"create file: %s", curr_item);
 
         if (create) {
@@ -503,8 +861,9 @@ void collective_helper(const int dirs, const int create, const char* path, uint6
 }
 
 /* recursive function to create and remove files/directories from the
-   directory tree */
-void create_remove_items(int currDepth, const int dirs, const int create, const int collective, const char *path, uint64_t dirNum, rank_progress_t * progress) {
+   directory tree named tree_name, the items are named after name */
+void create_remove_items(int currDepth, const int dirs, const int create, const int collective, const char *path, uint64_t dirNum,
+                         const char *tree_name, const char *name, rank_progress_t * progress) {
     unsigned i;
     char dir[MAX_PATHLEN];
     char temp_path[MAX_PATHLEN];
@@ -523,15 +882,15 @@ void create_remove_items(int currDepth, const int dirs, const int create, const
         /* create items at this depth */
         if (! o.leaf_only || (o.depth == 0 && o.leaf_only)) {
             if (collective) {
-                collective_helper(dirs, create, temp_path, 0, progress);
+                collective_helper(dirs, create, temp_path, 0, name, progress);
             } else {
-                create_remove_items_helper(dirs, create, temp_path, 0, progress);
+                create_remove_items_helper(dirs, create, temp_path, 0, name, progress);
             }
         }
 
         if (o.depth > 0) {
             create_remove_items(++currDepth, dirs, create,
-                                collective, temp_path, ++dirNum, progress);
+                                collective, temp_path, ++dirNum, tree_name, name, progress);
         }
 
     } else if (currDepth <= o.depth) {
@@ -539,7 +898,7 @@ void create_remove_items(int currDepth, const int dirs, const int create, const
         for (i=0; i< o.branch_factor; i++) {
 
             /* determine the current branch and append it to the path */
-            sprintf(dir, "%s.%llu/", o.base_tree_name, currDir);
+            sprintf(dir, "%s.%llu/", tree_name, currDir);
             strcat(temp_path, "/");
             strcat(temp_path, dir);
 
@@ -548,9 +907,9 @@ void create_remove_items(int currDepth, const int dirs, const int create, const
             /* create the items in this branch */
             if (! o.leaf_only || (o.leaf_only && currDepth == o.depth)) {
                 if (collective) {
-                    collective_helper(dirs, create, temp_path, currDir* o.items_per_dir, progress);
+                    collective_helper(dirs, create, temp_path, currDir* o.items_per_dir, name, progress);
                 } else {
-                    create_remove_items_helper(dirs, create, temp_path, currDir*o.items_per_dir, progress);
+                    create_remove_items_helper(dirs, create, temp_path, currDir*o.items_per_dir, name, progress);
                 }
             }
 
@@ -562,6 +921,8 @@ void create_remove_items(int currDepth, const int dirs, const int create, const
                 collective,
                 temp_path,
                 ( currDir * ( unsigned long long ) o.branch_factor ) + 1,
+                tree_name,
+                name,
                 progress
                );
             currDepth--;
@@ -573,13 +934,58 @@ void create_remove_items(int currDepth, const int dirs, const int create, const
     }
 }
 
-/* stats all of the items created as specified by the input parameters */
-void mdtest_stat(const int random, const int dirs, const long dir_iter, const char *path, rank_progress_t * progress) {
+/* stats the item with the ID i */
+static void stat_item(uint64_t i, const int random, const int dirs, item_path_t * ip, rank_progress_t * progress) {
     struct stat buf;
-    uint64_t parent_dir, item_num = 0;
-    char item[MAX_PATHLEN], temp[MAX_PATHLEN];
+    uint64_t item_num = item_number(i, random, ip);
+    char *item;
+
+    if ( (i % ITEM_COUNT == 0) && (i != 0)) {
+        VERBOSE(3,5,"stat %s: "LLU"", dirs ? "dir" : "file", i);
+    }
+
+    /* the full path of the file/dir to stat */
+    item = item_path_in_tree(ip, item_num);
+
+    VERBOSE(3,5,"mdtest_stat %4s: %s", (dirs ? "dir" : "file"), item);
+    double start = GetTimeStamp();
+    if (-1 == o.backend->stat (item, &buf, o.backend_options)) {
+        WARNF("unable to stat %s %s", dirs ? "directory" : "file", item);
+    }
+    record_op(progress, start);
+}
+
+/* stats the items start to end - 1 with bulk calls of up to md_batch items */
+static void stat_items_bulk(uint64_t start, uint64_t end, const int random, const int dirs, item_path_t * ip, rank_progress_t * progress) {
+    for (uint64_t i = start ; i < end ; ) {
+        int count = end - i < (uint64_t) o.md_batch ? (int) (end - i) : o.md_batch;
+        for (int k = 0; k < count; k++) {
+            strcpy(md_bulk.paths[k], item_path_in_tree(ip, item_number(i + k, random, ip)));
+            VERBOSE(3,5,"mdtest_stat %4s: %s", (dirs ? "dir" : "file"), md_bulk.paths[k]);
+        }
+        double t_start = GetTimeStamp();
+        if (aiori_bulk_stat(o.backend, md_bulk.paths, count, md_bulk.stats, md_bulk.results, o.backend_options) != 0) {
+            for (int k = 0; k < count; k++) {
+                if (md_bulk.results[k] != 0) {
+                    WARNF("unable to stat %s %s", dirs ? "directory" : "file", md_bulk.paths[k]);
+                }
+            }
+        }
+        for (int k = 0; k < count; k++) {
+            record_op(progress, t_start);
+        }
+        i += count;
+    }
+}
 
+static void stat_job_item(md_job_t * job, uint64_t i, int worker, item_path_t * ip) {
+    stat_item(i, job->random, job->dirs, ip, job->progress);
+}
+
+/* stats all of the items created as specified by the input parameters */
+void mdtest_stat(const int random, const int dirs, const long dir_iter, const char *path, rank_progress_t * progress) {
     VERBOSE(1,-1,"Entering mdtest_stat on %s", path );
+    const char *kind = dirs ? "dir." : "file.";
 
     uint64_t stop_items = o.items;
 
@@ -587,273 +993,184 @@ void mdtest_stat(const int random, const int dirs, const long dir_iter, const ch
       stop_items = o.items_per_dir;
     }
 
+    if (o.md_concurrency > 1) {
+        md_job_t job = {.fn = stat_job_item, .kind = kind, .name = o.stat_name, .progress = progress, .random = random, .dirs = dirs, .path = path, .end = stop_items};
+        md_run_job(& job);
+        return;
+    }
+
+    item_path_t ip;
+    item_path_init(& ip, path, kind, o.stat_name);
+    if (o.md_batch > 1) {
+        stat_items_bulk(0, stop_items, random, dirs, & ip, progress);
+        return;
+    }
     /* iterate over all of the item IDs */
     for (uint64_t i = 0 ; i < stop_items ; ++i) {
-        /*
-         * It doesn't make sense to pass the address of the array because that would
-         * be like passing char **. Tested it on a Cray and it seems to work either
-         * way, but it seems that it is correct without the "&".
-         *
-         memset(&item, 0, MAX_PATHLEN);
-        */
-        memset(item, 0, MAX_PATHLEN);
-        memset(temp, 0, MAX_PATHLEN);
-
-
-        /* determine the item number to stat */
-        if (random) {
-            item_num = o.rand_array[i];
-        } else {
-            item_num = i;
-        }
+        stat_item(i, random, dirs, & ip, progress);
+    }
+}
 
-        /* make adjustments if in leaf only mode*/
-        if (o.leaf_only) {
-            item_num += o.items_per_dir *
-                (o.num_dirs_in_tree - (uint64_t) pow( o.branch_factor, o.depth ));
-        }
+/* reads the item with the ID i */
+static void read_item(uint64_t i, int random, int dirs, item_path_t * ip, rank_progress_t * progress, char *read_buffer) {
+    uint64_t item_num = item_number(i, random, ip);
+    char *item;
+    aiori_fd_t *aiori_fh;
 
-        /* create name of file/dir to stat */
-        if (dirs) {
-            if ( (i % ITEM_COUNT == 0) && (i != 0)) {
-                VERBOSE(3,5,"stat dir: "LLU"", i);
-            }
-            sprintf(item, "dir.%s"LLU"", o.stat_name, item_num);
-        } else {
-            if ( (i % ITEM_COUNT == 0) && (i != 0)) {
-                VERBOSE(3,5,"stat file: "LLU"", i);
-            }
-            sprintf(item, "file.%s"LLU"", o.stat_name, item_num);
-        }
+    if ((i%ITEM_COUNT == 0) && (i != 0)) {
+        VERBOSE(3,5,"read file: "LLU"", i);
+    }
 
-        /* determine the path to the file/dir to be stat'ed */
-        parent_dir = item_num / o.items_per_dir;
+    /* the full path of the file to read */
+    item = item_path_in_tree(ip, item_num);
 
-        if (parent_dir > 0) {        //item is not in tree's root directory
+    VERBOSE(3,5,"mdtest_read file: %s", item);
 
-            /* prepend parent directory to item's path */
-            sprintf(temp, "%s."LLU"/%s", o.base_tree_name, parent_dir, item);
-            strcpy(item, temp);
+    double start = GetTimeStamp();
+    /* open file for reading */
+    aiori_fh = o.backend->open (item, O_RDONLY, o.backend_options);
+    if (NULL == aiori_fh) {
+        WARNF("unable to open file %s", item);
+        return;
+    }
 
-            //still not at the tree's root dir
-            while (parent_dir > o.branch_factor) {
-                parent_dir = (uint64_t) ((parent_dir-1) / o.branch_factor);
-                sprintf(temp, "%s."LLU"/%s", o.base_tree_name, parent_dir, item);
-                strcpy(item, temp);
-            }
+    /* read file */
+    if (o.read_bytes > 0) {
+        invalidate_buffer_pattern(read_buffer, o.read_bytes, o.gpuMemoryFlags);
+        if (o.read_bytes != (size_t) o.backend->xfer(READ, aiori_fh, (IOR_size_t *) read_buffer, o.read_bytes, 0, o.backend_options)) {
+            WARNF("unable to read file %s", item);
+            __atomic_fetch_add(& o.verification_error, 1, __ATOMIC_RELAXED);
+            return;
+        }     
+        int pretend_rank = (2 * o.nstride + rank) % o.size;
+        if(o.verify_read){
+          if (o.shared_file) {
+            pretend_rank = rank;
+          }
+          int error = verify_memory_pattern(item_num, read_buffer, o.read_bytes, o.random_buffer_offset, pretend_rank, o.dataPacketType, o.gpuMemoryFlags);
+          __atomic_fetch_add(& o.verification_error, error, __ATOMIC_RELAXED);
+          if(error){
+            VERBOSE(1,1,"verification error in file: %s", item);
+          }
         }
+    }
+    record_op(progress, start);
 
-        /* Now get item to have the full path */
-        sprintf( temp, "%s/%s", path, item );
-        strcpy( item, temp );
+    /* close file */
+    o.backend->close (aiori_fh, o.backend_options);
+}
 
-        /* below temp used to be hiername */
-        VERBOSE(3,5,"mdtest_stat %4s: %s", (dirs ? "dir" : "file"), item);
-        double start = GetTimeStamp();
-        if (-1 == o.backend->stat (item, &buf, o.backend_options)) {
-            WARNF("unable to stat %s %s", dirs ? "directory" : "file", item);
-        }
-        if(progress->ot) OpTimerValue(progress->ot, start - progress->start_time, GetTimeStamp() - start);        
-    }
+static void read_job_item(md_job_t * job, uint64_t i, int worker, item_path_t * ip) {
+    read_item(i, job->random, job->dirs, ip, job->progress, md_pool.read_buffers[worker]);
 }
 
 /* reads all of the items created as specified by the input parameters */
 void mdtest_read(int random, int dirs, const long dir_iter, char *path, rank_progress_t * progress) {
-    uint64_t parent_dir, item_num = 0;
-    char item[MAX_PATHLEN], temp[MAX_PATHLEN];
-    aiori_fd_t *aiori_fh;
-
     VERBOSE(1,-1,"Entering mdtest_read on %s", path );
     char *read_buffer;
 
-    /* allocate read buffer */
-    if (o.read_bytes > 0) {
-        read_buffer = aligned_buffer_alloc(o.read_bytes, o.gpuMemoryFlags);
-        invalidate_buffer_pattern(read_buffer, o.read_bytes, o.gpuMemoryFlags);
-    }
-
     uint64_t stop_items = o.items;
 
     if( o.directory_loops != 1 ){
       stop_items = o.items_per_dir;
     }
 
-    /* iterate over all of the item IDs */
-    for (uint64_t i = 0 ; i < stop_items ; ++i) {
-        /*
-         * It doesn't make sense to pass the address of the array because that would
-         * be like passing char **. Tested it on a Cray and it seems to work either
-         * way, but it seems that it is correct without the "&".
-         *
-         * NTH: Both are technically correct in C.
-         *
-         * memset(&item, 0, MAX_PATHLEN);
-         */
-        memset(item, 0, MAX_PATHLEN);
-        memset(temp, 0, MAX_PATHLEN);
+    o.hints.filePerProc = ! o.shared_file;
 
-        /* determine the item number to read */
-        if (random) {
-            item_num = o.rand_array[i];
-        } else {
-            item_num = i;
-        }
-
-        /* make adjustments if in leaf only mode*/
-        if (o.leaf_only) {
-            item_num += o.items_per_dir *
-                (o.num_dirs_in_tree - (uint64_t) pow (o.branch_factor, o.depth));
-        }
-
-        /* create name of file to read */
-        if (!dirs) {
-            if ((i%ITEM_COUNT == 0) && (i != 0)) {
-                VERBOSE(3,5,"read file: "LLU"", i);
-            }
-            sprintf(item, "file.%s"LLU"", o.read_name, item_num);
-        }
-
-        /* determine the path to the file/dir to be read'ed */
-        parent_dir = item_num / o.items_per_dir;
-
-        if (parent_dir > 0) {        //item is not in tree's root directory
-
-            /* prepend parent directory to item's path */
-            sprintf(temp, "%s."LLU"/%s", o.base_tree_name, parent_dir, item);
-            strcpy(item, temp);
-
-            /* still not at the tree's root dir */
-            while (parent_dir > o.branch_factor) {
-                parent_dir = (unsigned long long) ((parent_dir-1) / o.branch_factor);
-                sprintf(temp, "%s."LLU"/%s", o.base_tree_name, parent_dir, item);
-                strcpy(item, temp);
-            }
-        }
-
-        /* Now get item to have the full path */
-        sprintf( temp, "%s/%s", path, item );
-        strcpy( item, temp );
-
-        /* below temp used to be hiername */
-        VERBOSE(3,5,"mdtest_read file: %s", item);
-
-        o.hints.filePerProc = ! o.shared_file;
-
-        double start = GetTimeStamp();
-        /* open file for reading */
-        aiori_fh = o.backend->open (item, O_RDONLY, o.backend_options);
-        if (NULL == aiori_fh) {
-            WARNF("unable to open file %s", item);
-            continue;
-        }
+    if (o.md_concurrency > 1) {
+        md_job_t job = {.fn = read_job_item, .kind = "file.", .name = o.read_name, .progress = progress, .random = random, .dirs = dirs, .path = path, .end = stop_items};
+        md_run_job(& job);
+        return;
+    }
 
-        /* read file */
-        if (o.read_bytes > 0) {
-            invalidate_buffer_pattern(read_buffer, o.read_bytes, o.gpuMemoryFlags);
-            if (o.read_bytes != (size_t) o.backend->xfer(READ, aiori_fh, (IOR_size_t *) read_buffer, o.read_bytes, 0, o.backend_options)) {
-                WARNF("unable to read file %s", item);
-                o.verification_error += 1;
-                continue;
-            }     
-            int pretend_rank = (2 * o.nstride + rank) % o.size;
-            if(o.verify_read){
-              if (o.shared_file) {
-                pretend_rank = rank;
-              }
-              int error = verify_memory_pattern(item_num, read_buffer, o.read_bytes, o.random_buffer_offset, pretend_rank, o.dataPacketType, o.gpuMemoryFlags);
-              o.verification_error += error;
-              if(error){
-                VERBOSE(1,1,"verification error in file: %s", item);
-              }
-            }
-        }
-        if(progress->ot) OpTimerValue(progress->ot, start - progress->start_time, GetTimeStamp() - start);
+    /* allocate read buffer */
+    if (o.read_bytes > 0) {
+        read_buffer = aligned_buffer_alloc(o.read_bytes, o.gpuMemoryFlags);
+        invalidate_buffer_pattern(read_buffer, o.read_bytes, o.gpuMemoryFlags);
+    }
 
-        /* close file */
-        o.backend->close (aiori_fh, o.backend_options);
+    item_path_t ip;
+    item_path_init(& ip, path, "file.", o.read_name);
+    /* iterate over all of the item IDs */
+    for (uint64_t i = 0 ; i < stop_items ; ++i) {
+        read_item(i, random, dirs, & ip, progress, read_buffer);
     }
     if(o.read_bytes){
       aligned_buffer_free(read_buffer, o.gpuMemoryFlags);
     }
 }
 
-/* This method should be called by rank 0.  It subsequently does all of
-   the creates and removes for the other ranks */
+/*
+ * Collective creates (-c): the creates and removes of all tasks are done by
+ * collective_aggregators tasks.  The tasks are split into contiguous blocks,
+ * one per aggregator, and the first task of a block is its aggregator.
+ */
+static int collective_aggregator_count(int ntasks) {
+    return o.collective_aggregators < ntasks ? o.collective_aggregators : ntasks;
+}
+
+/* the index of the aggregator of this task, -1 if it is none */
+static int collective_aggregator(int ntasks) {
+    int aggs = collective_aggregator_count(ntasks);
+    for (int a = 0; a < aggs; a++) {
+        if ((int64_t) a * ntasks / aggs == rank) {
+            return a;
+        }
+    }
+    return -1;
+}
+
+/* the first task after the block of aggregator a */
+static int collective_aggregator_end(int a, int ntasks) {
+    return (int64_t) (a + 1) * ntasks / collective_aggregator_count(ntasks);
+}
+
+/* This method must be called by all tasks, the aggregators do the creates and
+   removes for the tasks of their block */
 void collective_create_remove(const int create, const int dirs, const int ntasks, const char *path, rank_progress_t * progress) {
     char temp[MAX_PATHLEN];
+    char tree_name[MAX_PATHLEN];
+    char name[MAX_PATHLEN];
+    int aggregator = collective_aggregator(ntasks);
+    uint64_t items = o.directory_loops != 1 ? o.items_per_dir : o.items;
+    double result[2] = {0, 0}; /* items, time */
 
     VERBOSE(1,-1,"Entering collective_create_remove on %s", path );
 
-    /* rank 0 does all of the creates and removes for all of the ranks */
-    for (int i = 0 ; i < ntasks ; ++i) {
-        memset(temp, 0, MAX_PATHLEN);
-
-        strcpy(temp, o.testdir);
-        strcat(temp, "/");
+    if (aggregator >= 0) {
+        int end = collective_aggregator_end(aggregator, ntasks);
+        double start = GetTimeStamp();
+        for (int i = rank ; i < end ; ++i) {
+            if (o.unique_dir_per_task) {
+                sprintf(tree_name, "mdtest_tree.%d", i);
+            } else {
+                sprintf(tree_name, "mdtest_tree");
+            }
+            sprintf(temp, "%s/%s.0", o.testdir, tree_name);
+            sprintf(name, "mdtest.%d.", (i+((create ? 0 : 3)*o.nstride))%ntasks);
 
-        /* set the base tree name appropriately */
-        if (o.unique_dir_per_task) {
-            sprintf(o.base_tree_name, "mdtest_tree.%d", i);
-        } else {
-            sprintf(o.base_tree_name, "mdtest_tree");
+            VERBOSE(3,5,"collective_create_remove (create_remove_items): temp is '%s'", temp);
+            create_remove_items(0, dirs, create, 1, temp, 0, tree_name, name, progress);
         }
+        result[0] = items * (end - rank);
+        result[1] = GetTimeStamp() - start;
+    }
 
-        /* Setup to do I/O to the appropriate test dir */
-        strcat(temp, o.base_tree_name);
-        strcat(temp, ".0");
-
-        /* set all item names appropriately */
-        if (! o.shared_file) {
-            sprintf(o.mk_name, "mdtest.%d.", (i+(0*o.nstride))%ntasks);
-            sprintf(o.stat_name, "mdtest.%d.", (i+(1*o.nstride))%ntasks);
-            sprintf(o.read_name, "mdtest.%d.", (i+(2*o.nstride))%ntasks);
-            sprintf(o.rm_name, "mdtest.%d.", (i+(3*o.nstride))%ntasks);
+    if (verbose >= 1) {
+        double * results = NULL;
+        if (rank == 0) {
+            results = safeMalloc(sizeof(result) * ntasks);
         }
-        if (o.unique_dir_per_task) {
-            VERBOSE(3,5,"i %d nstride %d ntasks %d", i, o.nstride, ntasks);
-            sprintf(o.unique_mk_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                    (i+(0*o.nstride))%ntasks);
-            sprintf(o.unique_chdir_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                    (i+(1*o.nstride))%ntasks);
-            sprintf(o.unique_stat_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                    (i+(2*o.nstride))%ntasks);
-            sprintf(o.unique_read_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                    (i+(3*o.nstride))%ntasks);
-            sprintf(o.unique_rm_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                    (i+(4*o.nstride))%ntasks);
-            sprintf(o.unique_rm_uni_dir, "%s", o.testdir);
+        MPI_CHECK(MPI_Gather(result, 2, MPI_DOUBLE, results, 2, MPI_DOUBLE, 0, testComm), "MPI_Gather error");
+        if (rank == 0) {
+            for (int a = 0; a < collective_aggregator_count(ntasks); a++) {
+                int task = (int64_t) a * ntasks / collective_aggregator_count(ntasks);
+                double * r = & results[2 * task];
+                VERBOSE(1,-1,"collective %s of %s: aggregator %d (task %d): %.0f items, %14.3f sec, %14.3f ops/sec",
+                        create ? "create" : "remove", dirs ? "directories" : "files", a, task, r[0], r[1], r[1] > 0 ? r[0] / r[1] : 0.0);
+            }
+            free(results);
         }
-
-        /* Now that everything is set up as it should be, do the create or remove */
-        VERBOSE(3,5,"collective_create_remove (create_remove_items): temp is '%s'", temp);
-
-        create_remove_items(0, dirs, create, 1, temp, 0, progress);
-    }
-
-    /* reset all of the item names */
-    if (o.unique_dir_per_task) {
-        sprintf(o.base_tree_name, "mdtest_tree.0");
-    } else {
-        sprintf(o.base_tree_name, "mdtest_tree");
-    }
-    if (! o.shared_file) {
-        sprintf(o.mk_name, "mdtest.%d.", (0+(0*o.nstride))%ntasks);
-        sprintf(o.stat_name, "mdtest.%d.", (0+(1*o.nstride))%ntasks);
-        sprintf(o.read_name, "mdtest.%d.", (0+(2*o.nstride))%ntasks);
-        sprintf(o.rm_name, "mdtest.%d.", (0+(3*o.nstride))%ntasks);
-    }
-    if (o.unique_dir_per_task) {
-        sprintf(o.unique_mk_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                (0+(0*o.nstride))%ntasks);
-        sprintf(o.unique_chdir_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                (0+(1*o.nstride))%ntasks);
-        sprintf(o.unique_stat_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                (0+(2*o.nstride))%ntasks);
-        sprintf(o.unique_read_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                (0+(3*o.nstride))%ntasks);
-        sprintf(o.unique_rm_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                (0+(4*o.nstride))%ntasks);
-        sprintf(o.unique_rm_uni_dir, "%s", o.testdir);
     }
 }
 
@@ -980,12 +1297,10 @@ void directory_test(const int iteration, const int ntasks, const char *path, ran
 
         /* "touch" the files */
         if (o.collective_creates) {
-            if (rank == 0) {
-                collective_create_remove(1, 1, ntasks, temp_path, progress);
-            }
+            collective_create_remove(1, 1, ntasks, temp_path, progress);
         } else {
             /* create directories */
-            create_remove_items(0, 1, 1, 0, temp_path, 0, progress);
+            create_remove_items(0, 1, 1, 0, temp_path, 0, o.base_tree_name, o.mk_name, progress);
         }
       }
       progress->stone_wall_timer_seconds = 0;
@@ -1099,11 +1414,9 @@ void directory_test(const int iteration, const int ntasks, const char *path, ran
 
         /* remove directories */
         if (o.collective_creates) {
-            if (rank == 0) {
-                collective_create_remove(0, 1, ntasks, temp_path, progress);
-            }
+            collective_create_remove(0, 1, ntasks, temp_path, progress);
         } else {
-            create_remove_items(0, 1, 0, 0, temp_path, 0, progress);
+            create_remove_items(0, 1, 0, 0, temp_path, 0, o.base_tree_name, o.rm_name, progress);
         }
       }
       t_end_before_barrier = GetTimeStamp();
@@ -1204,14 +1517,12 @@ void file_test_create(const int iteration, const int ntasks, const char *path, r
     VERBOSE(3,-1,"file_test: create path is '%s'", temp_path );
     /* "touch" the files */
     if (o.collective_creates) {
-        if (rank == 0) {
-            collective_create_remove(1, 0, ntasks, temp_path, progress);
-        }
+        collective_create_remove(1, 0, ntasks, temp_path, progress);
         MPI_CHECK(MPI_Barrier(testComm), "MPI_Barrier error");
     }
       
     /* create files */
-    create_remove_items(0, 0, 1, 0, temp_path, 0, progress);
+    create_remove_items(0, 0, 1, 0, temp_path, 0, o.base_tree_name, o.mk_name, progress);
     if(o.stone_wall_timer_seconds){
       // hit the stonewall
       uint64_t max_iter = 0;
@@ -1222,7 +1533,7 @@ void file_test_create(const int iteration, const int ntasks, const char *path, r
       if (hit){
         progress->stone_wall_timer_seconds = 0;
         VERBOSE(1,1,"stonewall: %lld of %lld", (long long) progress->items_start, (long long) progress->items_per_dir);
-        create_remove_items(0, 0, 1, 0, temp_path, 0, progress);
+        create_remove_items(0, 0, 1, 0, temp_path, 0, o.base_tree_name, o.mk_name, progress);
         // now reset the values
         progress->stone_wall_timer_seconds = o.stone_wall_timer_seconds;
         o.items = progress->items_done;
@@ -1255,7 +1566,7 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
       phase_prepare();
       if(o.savePerOpDataCSV != NULL) {
         char path[MAX_PATHLEN];
-        sprintf(path, "%s-%s-%05d.csv", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_CREATE_NUM), rank);
+        sprintf(path, "%s-%s-%05d.optrace", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_CREATE_NUM), rank);
         progress->ot = OpTimerInit(path, o.write_bytes > 0 ? o.write_bytes : 1);
       }      
       t_start = GetTimeStamp();
@@ -1315,7 +1626,7 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
       phase_prepare();
       if(o.savePerOpDataCSV != NULL) {
         char path[MAX_PATHLEN];
-        sprintf(path, "%s-%s-%05d.csv", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_STAT_NUM), rank);
+        sprintf(path, "%s-%s-%05d.optrace", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_STAT_NUM), rank);
         progress->ot = OpTimerInit(path, 1);
       }            
       t_start = GetTimeStamp();
@@ -1348,7 +1659,7 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
       phase_prepare();
       if(o.savePerOpDataCSV != NULL) {
         char path[MAX_PATHLEN];
-        sprintf(path, "%s-%s-%05d.csv", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_READ_NUM), rank);
+        sprintf(path, "%s-%s-%05d.optrace", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_READ_NUM), rank);
         progress->ot = OpTimerInit(path, o.read_bytes > 0 ? o.read_bytes : 1);
       }            
       t_start = GetTimeStamp();
@@ -1384,7 +1695,7 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
     if (o.remove_only) {
       phase_prepare();
       if(o.savePerOpDataCSV != NULL) {
-        sprintf(temp_path, "%s-%s-%05d.csv", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_REMOVE_NUM), rank);
+        sprintf(temp_path, "%s-%s-%05d.optrace", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_REMOVE_NUM), rank);
         progress->ot = OpTimerInit(temp_path, o.write_bytes > 0 ? o.write_bytes : 1);
       }      
       t_start = GetTimeStamp();
@@ -1403,12 +1714,10 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
 
         VERBOSE(3,5,"file_test: rm directories path is '%s'", temp_path );
         if (o.collective_creates) {
-            if (rank == 0) {
-                collective_create_remove(0, 0, ntasks, temp_path, progress);
-            }
+            collective_create_remove(0, 0, ntasks, temp_path, progress);
         } else {
             VERBOSE(3,5,"gonna remove %s", temp_path);
-            create_remove_items(0, 0, 0, 0, temp_path, 0, progress);
+            create_remove_items(0, 0, 0, 0, temp_path, 0, o.base_tree_name, o.rm_name, progress);
         }
       }
       t_end_before_barrier = GetTimeStamp();
@@ -1838,6 +2147,27 @@ void md_validate_tests() {
     if (o.collective_creates && !o.barriers) {
         FAIL("-c not compatible with -B");
     }
+    if (o.collective_aggregators < 1) {
+        FAIL("--collective-aggregators must be at least 1");
+    }
+
+    /* check for concurrent metadata operations */
+    if (o.md_concurrency < 0) {
+        FAIL("--md-concurrency must be positive");
+    }
+    if (o.md_concurrency > 1 && ! o.backend->thread_safe) {
+        FAIL("--md-concurrency requires a thread-safe API, %s is not", o.backend->name);
+    }
+    if (o.md_batch < 0) {
+        FAIL("--md-batch must be positive");
+    }
+    if (o.md_batch > 1 && o.md_concurrency > 1) {
+        FAIL("--md-batch not compatible with --md-concurrency");
+    }
+
+    if (o.dataPacketType == DATA_COMPRESSIBLE && (o.gpuMemoryFlags == IOR_MEMORY_TYPE_GPU_MANAGED_CHECK_GPU || o.gpuMemoryFlags == IOR_MEMORY_TYPE_GPU_DEVICE_ONLY)) {
+        FAIL("the compressible data packet type is not available for patterns on the GPU, use --allocateBufferOnGPU=1");
+    }
 
     /* check for shared file incompatibilities */
     if (o.unique_dir_per_task && o.shared_file && rank == 0) {
@@ -1972,7 +2302,7 @@ void show_file_system_size(char *file_system) {
 }
 
 void create_remove_directory_tree(int create,
-                                  int currDepth, char* path, int dirNum, rank_progress_t * progress) {
+                                  int currDepth, char* path, int dirNum, const char *tree_name, rank_progress_t * progress) {
 
     unsigned i;
     char dir[MAX_PATHLEN];
@@ -1981,7 +2311,7 @@ void create_remove_directory_tree(int create,
     VERBOSE(1,5,"Entering create_remove_directory_tree on %s, currDepth = %d...", path, currDepth );
 
     if (currDepth == 0) {
-        sprintf(dir, "%s/%s.%d/", path, o.base_tree_name, dirNum);
+        sprintf(dir, "%s/%s.%d/", path, tree_name, dirNum);
 
         if (create) {
             VERBOSE(2,5,"Making directory '%s'", dir);
@@ -1999,7 +2329,7 @@ void create_remove_directory_tree(int create,
 #endif /* HAVE_LUSTRE_LUSTREAPI */
         }
 
-        create_remove_directory_tree(create, ++currDepth, dir, ++dirNum, progress);
+        create_remove_directory_tree(create, ++currDepth, dir, ++dirNum, tree_name, progress);
 
         if (!create) {
             VERBOSE(2,5,"Remove directory '%s'", dir);
@@ -2014,7 +2344,7 @@ void create_remove_directory_tree(int create,
         int currDir = dirNum;
 
         for (i=0; i < o.branch_factor; i++) {
-            sprintf(dir, "%s.%d/", o.base_tree_name, currDir);
+            sprintf(dir, "%s.%d/", tree_name, currDir);
             strcat(temp_path, dir);
 
             if (create) {
@@ -2025,7 +2355,7 @@ void create_remove_directory_tree(int create,
             }
 
             create_remove_directory_tree(create, ++currDepth,
-                                         temp_path, (o.branch_factor*currDir)+1, progress);
+                                         temp_path, (o.branch_factor*currDir)+1, tree_name, progress);
             currDepth--;
 
             if (!create) {
@@ -2041,6 +2371,64 @@ void create_remove_directory_tree(int create,
     }
 }
 
+/*
+ * Creates or removes the shared directory tree level by level, the
+ * directories of a level are distributed across all tasks, which synchronize
+ * before the next level.  Removal starts with the deepest level.
+ */
+static void create_remove_directory_tree_parallel(int create, const char *path) {
+    char root[MAX_PATHLEN];
+    uint64_t first[o.depth + 1];
+    uint64_t count[o.depth + 1];
+    item_path_t ip;
+
+    VERBOSE(1,5,"Entering create_remove_directory_tree_parallel on %s", path );
+
+    if (snprintf(root, MAX_PATHLEN, "%s/%s.0", path, o.base_tree_name) >= MAX_PATHLEN)
+        FAIL("path %s/%s.0 is too long", path, o.base_tree_name);
+    item_path_init(& ip, root, "", "");
+
+    first[0] = 0;
+    count[0] = 1;
+    for (int l = 1; l <= o.depth; l++) {
+        first[l] = first[l-1] * o.branch_factor + 1;
+        count[l] = count[l-1] * o.branch_factor;
+    }
+
+    for (int step = 0; step <= o.depth; step++) {
+        int l = create ? step : o.depth - step;
+        uint64_t start = first[l] + count[l] * rank / o.size;
+        uint64_t end = first[l] + count[l] * (rank + 1) / o.size;
+
+        for (uint64_t d = start; d < end; d++) {
+            char *dir = item_path_dir(& ip, d);
+            if (create) {
+                VERBOSE(2,5,"Making directory '%s'", dir);
+                if (-1 == o.backend->mkdir (dir, DIRMODE, o.backend_options)) {
+                    WARNF("unable to create tree directory '%s'", dir);
+                }
+#ifdef HAVE_LUSTRE_LUSTREAPI
+                /* internal node for branching, can be non-striped for children */
+                if (d == 0 && o.global_dir_layout && \
+                    llapi_dir_set_default_lmv_stripe(dir, -1, 0,
+                                                     LMV_HASH_TYPE_FNV_1A_64,
+                                                     NULL) == -1) {
+                    FAIL("Unable to reset to global default directory layout");
+                }
+#endif /* HAVE_LUSTRE_LUSTREAPI */
+            } else {
+                VERBOSE(2,5,"Remove directory '%s'", dir);
+                if (-1 == o.backend->rmdir(dir, o.backend_options)) {
+                    WARNF("Unable to remove directory %s", dir);
+                }
+            }
+        }
+        if (step < o.depth) {
+            MPI_CHECK(MPI_Barrier(testComm), "MPI_Barrier error");
+        }
+    }
+}
+
 static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
   rank_progress_t progress_o;
   memset(& progress_o, 0 , sizeof(progress_o));
@@ -2083,24 +2471,20 @@ static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
       prep_testdir(j, dir_iter);
 
       if (o.unique_dir_per_task) {
-        if (o.collective_creates && (rank == 0)) {
-          /*
-           * This is inside two loops, one of which already uses "i" and the other uses "j".
-           * I don't know how this ever worked. I'm changing this loop to use "k".
-           */
-          for (k=0; k < o.size; k++) {
-            sprintf(o.base_tree_name, "mdtest_tree.%d", k);
+        if (o.collective_creates) {
+          /* the aggregators create the trees of the tasks of their block */
+          int aggregator = collective_aggregator(o.size);
+          int end = aggregator < 0 ? rank : collective_aggregator_end(aggregator, o.size);
+          for (k=rank; k < end; k++) {
+            char tree_name[MAX_PATHLEN];
+            sprintf(tree_name, "mdtest_tree.%d", k);
 
             VERBOSE(3,5,"main (create hierarchical directory loop-collective): Calling create_remove_directory_tree with '%s'", o.testdir );
             /*
              * Let's pass in the path to the directory we most recently made so that we can use
              * full paths in the other calls.
              */
-            create_remove_directory_tree(1, 0, o.testdir, 0, progress);
-            if(CHECK_STONE_WALL(progress)){
-              o.size = k;
-              break;
-            }
+            create_remove_directory_tree(1, 0, o.testdir, 0, tree_name, progress);
           }
         } else if (! o.collective_creates) {
           VERBOSE(3,5,"main (create hierarchical directory loop-!collective_creates): Calling create_remove_directory_tree with '%s'", o.testdir );
@@ -2108,8 +2492,11 @@ static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
            * Let's pass in the path to the directory we most recently made so that we can use
            * full paths in the other calls.
            */
-          create_remove_directory_tree(1, 0, o.testdir, 0, progress);
+          create_remove_directory_tree(1, 0, o.testdir, 0, o.base_tree_name, progress);
         }
+      } else if (o.path_count <= 1) {
+        /* all tasks use the same test directory */
+        create_remove_directory_tree_parallel(1, o.testdir);
       } else {
         if (rank == 0) {
           VERBOSE(3,5,"main (create hierarchical directory loop-!unque_dir_per_task): Calling create_remove_directory_tree with '%s'", o.testdir );
@@ -2118,7 +2505,7 @@ static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
            * Let's pass in the path to the directory we most recently made so that we can use
            * full paths in the other calls.
            */
-          create_remove_directory_tree(1, 0 , o.testdir, 0, progress);
+          create_remove_directory_tree(1, 0 , o.testdir, 0, o.base_tree_name, progress);
         }
       }
     }
@@ -2190,13 +2577,13 @@ static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
       for (int dir_iter = 0; dir_iter < o.directory_loops; dir_iter ++){
         prep_testdir(j, dir_iter);
         if (o.unique_dir_per_task) {
-            if (o.collective_creates && (rank == 0)) {
-                /*
-                 * This is inside two loops, one of which already uses "i" and the other uses "j".
-                 * I don't know how this ever worked. I'm changing this loop to use "k".
-                 */
-                for (k=0; k < o.size; k++) {
-                    sprintf(o.base_tree_name, "mdtest_tree.%d", k);
+            if (o.collective_creates) {
+                /* the aggregators remove the trees of the tasks of their block */
+                int aggregator = collective_aggregator(o.size);
+                int end = aggregator < 0 ? rank : collective_aggregator_end(aggregator, o.size);
+                for (k=rank; k < end; k++) {
+                    char tree_name[MAX_PATHLEN];
+                    sprintf(tree_name, "mdtest_tree.%d", k);
 
                     VERBOSE(3,-1,"main (remove hierarchical directory loop-collective): Calling create_remove_directory_tree with '%s'", o.testdir );
 
@@ -2204,11 +2591,7 @@ static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
                      * Let's pass in the path to the directory we most recently made so that we can use
                      * full paths in the other calls.
                      */
-                    create_remove_directory_tree(0, 0, o.testdir, 0, progress);
-                    if(CHECK_STONE_WALL(progress)){
-                      o.size = k;
-                      break;
-                    }
+                    create_remove_directory_tree(0, 0, o.testdir, 0, tree_name, progress);
                 }
             } else if (! o.collective_creates) {
                 VERBOSE(3,-1,"main (remove hierarchical directory loop-!collective): Calling create_remove_directory_tree with '%s'", o.testdir );
@@ -2217,8 +2600,11 @@ static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
                  * Let's pass in the path to the directory we most recently made so that we can use
                  * full paths in the other calls.
                  */
-                create_remove_directory_tree(0, 0, o.testdir, 0, progress);
+                create_remove_directory_tree(0, 0, o.testdir, 0, o.base_tree_name, progress);
             }
+        } else if (o.path_count <= 1) {
+            /* all tasks use the same test directory */
+            create_remove_directory_tree_parallel(0, o.testdir);
         } else {
             if (rank == 0) {
                 VERBOSE(3,-1,"V-3: main (remove hierarchical directory loop-!unique_dir_per_task): Calling create_remove_directory_tree with '%s'", o.testdir );
@@ -2227,7 +2613,7 @@ static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
                  * Let's pass in the path to the directory we most recently made so that we can use
                  * full paths in the other calls.
                  */
-                create_remove_directory_tree(0, 0 , o.testdir, 0, progress);
+                create_remove_directory_tree(0, 0 , o.testdir, 0, o.base_tree_name, progress);
             }
         }
       }
@@ -2259,6 +2645,7 @@ void mdtest_init_args(){
   o = (mdtest_options_t) {
      .barriers = 1,
      .branch_factor = 1,
+     .collective_aggregators = 1,
      .random_buffer_offset = -1,
      .prologue = "",
      .epilogue = "",
@@ -2293,6 +2680,7 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
     int no_barriers = 0;
     char * path = "./out";
     int randomize = 0;
+    int permutation_seed;
     char APIs[1024];
     char APIs_legacy[1024];
     aiori_supported_apis(APIs, APIs_legacy, MDTEST);
@@ -2334,7 +2722,10 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
       {0, "random-seed", "random seed for -R", OPTION_OPTIONAL_ARGUMENT, 'd', & o.random_seed},
       {'s', NULL,        "stride between the number of tasks for each test", OPTION_OPTIONAL_ARGUMENT, 'd', & stride},
       {'S', NULL,        "shared file access (file only, no directories)", OPTION_FLAG, 'd', & o.shared_file},
-      {'c', NULL,        "collective creates: task 0 does all creates", OPTION_FLAG, 'd', & o.collective_creates},
+      {'c', NULL,        "collective creates: a few aggregator tasks do all creates", OPTION_FLAG, 'd', & o.collective_creates},
+      {0, "collective-aggregators", "number of tasks doing the creates and removes for -c, each for a contiguous block of tasks", OPTION_OPTIONAL_ARGUMENT, 'd', & o.collective_aggregators},
+      {0, "md-batch", "number of items per bulk metadata call for the file create and remove phases and the stat phases, uses the bulk interface of the API if present", OPTION_OPTIONAL_ARGUMENT, 'd', & o.md_batch},
+      {0, "md-concurrency", "number of metadata operations each task keeps in flight using a pool of threads, requires a thread-safe API", OPTION_OPTIONAL_ARGUMENT, 'd', & o.md_concurrency},
       {'t', NULL,        "time unique working directory overhead", OPTION_FLAG, 'd', & o.time_unique_dir_overhead},
       {'u', NULL,        "unique working directory for each task", OPTION_FLAG, 'd', & o.unique_dir_per_task},
       {'v', NULL,        "verbosity (each instance of option increments by one)", OPTION_FLAG, 'd', & verbose},
@@ -2348,7 +2739,7 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
       {'Y', NULL,        "call the sync command after each phase (included in the timing; note it causes all IO to be flushed from your node)", OPTION_FLAG, 'd', & o.call_sync},
       {'z', NULL,        "depth of hierarchical directory structure", OPTION_OPTIONAL_ARGUMENT, 'd', & o.depth},
       {'Z', NULL,        "print time instead of rate", OPTION_FLAG, 'd', & o.print_time},
-      {0, "dataPacketType", "type of packet that will be created [offset|incompressible|timestamp|random|o|i|t|r]", OPTION_OPTIONAL_ARGUMENT, 's', & packetType},
+      {0, "dataPacketType", "type of packet that will be created [offset|incompressible|timestamp|random|compressible|o|i|t|r|c]", OPTION_OPTIONAL_ARGUMENT, 's', & packetType},
       {0, "run-cmd-before-phase", "call this external command before each phase (excluded from the timing)", OPTION_OPTIONAL_ARGUMENT, 's', & o.prologue},
       {0, "run-cmd-after-phase",  "call this external command after each phase (included in the timing)", OPTION_OPTIONAL_ARGUMENT, 's', & o.epilogue},
 #ifdef HAVE_CUDA
@@ -2360,7 +2751,7 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
 #endif
       {0, "warningAsErrors",        "Any warning should lead to an error.", OPTION_FLAG, 'd', & aiori_warning_as_errors},
       {0, "saveRankPerformanceDetails", "Save the individual rank information into this CSV file.", OPTION_OPTIONAL_ARGUMENT, 's', & o.saveRankDetailsCSV},
-      {0, "savePerOpDataCSV", "Store the performance of each rank into an individual file prefixed with this option.", OPTION_OPTIONAL_ARGUMENT, 's', & o.savePerOpDataCSV},
+      {0, "savePerOpDataCSV", "Store the time and latency of each operation of each rank into an individual binary trace file prefixed with this option; convert it with contrib/optrace2csv.", OPTION_OPTIONAL_ARGUMENT, 's', & o.savePerOpDataCSV},
       {0, "showRankStatistics", "Include statistics per rank", OPTION_FLAG, 'd', & o.show_perrank_statistics},
       LAST_OPTION
     };
@@ -2411,6 +2802,7 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
     if (path != NULL){
       parse_dirpath(path);
     }
+    permutation_seed = o.random_seed;
     if( randomize > 0 ){
       if (o.random_seed == 0) {
         /* Ensure all procs have the same random number */
@@ -2418,6 +2810,7 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
           MPI_CHECK(MPI_Barrier(testComm), "MPI_Barrier error");
           MPI_CHECK(MPI_Bcast(& o.random_seed, 1, MPI_INT, 0, testComm), "MPI_Bcast error");
       }
+      permutation_seed = o.random_seed;
       o.random_seed += rank;
     }
     if( o.random_buffer_offset == -1 ){
@@ -2434,6 +2827,7 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
     VERBOSE(1,-1, "api                     : %s", o.api);
     VERBOSE(1,-1, "barriers                : %s", ( o.barriers ? "True" : "False" ));
     VERBOSE(1,-1, "collective_creates      : %s", ( o.collective_creates ? "True" : "False" ));
+    VERBOSE(1,-1, "collective_aggregators  : %d", o.collective_aggregators );
     VERBOSE(1,-1, "create_only             : %s", ( o.create_only ? "True" : "False" ));
     VERBOSE(1,-1, "dirpath(s):" );
     for ( i = 0; i < o.path_count; i++ ) {
@@ -2509,42 +2903,10 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
         }
     }
 
-    /* initialize rand_array */
-    if (o.random_seed > 0) {
-        srand(o.random_seed);
-
-        uint64_t s;
-
-        o.rand_array = (uint64_t *) safeMalloc( o.items * sizeof(*o.rand_array));
-
-        for (s=0; s < o.items; s++) {
-            o.rand_array[s] = s;
-        }
-
-        /* shuffle list randomly */
-        uint64_t n = o.items;
-        while (n>1) {
-            n--;
-
-            /*
-             * Generate a random number in the range 0 .. n
-             *
-             * rand() returns a number from 0 .. RAND_MAX. Divide that
-             * by RAND_MAX and you get a floating point number in the
-             * range 0 .. 1. Multiply that by n and you get a number in
-             * the range 0 .. n.
-             */
-            uint64_t k = ( uint64_t ) ((( double )rand() / ( double )RAND_MAX ) * ( double )n );
-
-            /*
-             * Now move the nth element to the kth (randomly chosen)
-             * element, and the kth element to the nth element.
-             */
-
-            uint64_t tmp = o.rand_array[k];
-            o.rand_array[k] = o.rand_array[n];
-            o.rand_array[n] = tmp;
-        }
+    /* the order of the items for -R, evaluated on the fly */
+    if (o.random_seed > 0 && o.items > 0) {
+        /* keyed with the seed before the rank offset, the same on every rank */
+        random_permutation_init(& o.rand_perm, o.items, permutation_seed);
     }
 
     /* allocate and initialize write buffer with # */
@@ -2553,6 +2915,13 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
         generate_memory_pattern(o.write_buffer, o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
     }
 
+    if (o.md_concurrency > 1) {
+        md_pool_init();
+    }
+    if (o.md_batch > 1) {
+        md_bulk_init();
+    }
+
     /* setup directory path to work in */
     if (o.path_count == 0) { /* special case where no directory path provided with '-d' option */
         char *ret = getcwd(o.testdirpath, MAX_PATHLEN);
@@ -2700,8 +3069,11 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
 
     VERBOSE(0,-1,"-- finished at %s --\n", PrintTimestamp());
 
-    if (o.random_seed > 0) {
-        free(o.rand_array);
+    if (o.md_batch > 1) {
+      md_bulk_free();
+    }
+    if (o.md_concurrency > 1) {
+      md_pool_free();
     }
 
     if (o.backend->finalize){
@@ -67,6 +67,45 @@ static void CheckRunSettings(IOR_test_t *tests)
         }
 }
 
+/*
+ * Replace every test whose module options describe a parameter sweep by one
+ * test per point of the sweep and renumber the tests.
+ */
+static IOR_test_t *ExpandSweeps(IOR_test_t *tests)
+{
+        IOR_test_t **link = &tests;
+        int test_num = 0;
+
+        while (*link != NULL) {
+                IOR_test_t *test = *link;
+                const ior_aiori_t *backend = test->params.backend;
+                int points = 1;
+
+                if (backend->sweep_points && test->params.backend_options)
+                        points = backend->sweep_points(test->params.backend_options);
+                if (points <= 1) {
+                        test->params.id = test_num++;
+                        link = &test->next;
+                        continue;
+                }
+                IOR_test_t *next = test->next;
+                for (int i = 0; i < points; i++) {
+                        IOR_test_t *point = CreateTest(&test->params, test_num++);
+                        aiori_mod_opt_t *options;
+                        free(backend->get_options(&options, test->params.backend_options));
+                        backend->sweep_select(options, i);
+                        point->params.backend_options = options;
+                        AllocResults(point);
+                        *link = point;
+                        link = &point->next;
+                }
+                *link = next;
+                free(test->results);
+                free(test);
+        }
+        return tests;
+}
+
 /*
  * Set flags from commandline string/value pairs.
  */
@@ -172,6 +211,8 @@ void DecodeDirective(char *line, IOR_param_t *params, options_all_t * module_opt
                 params->interTestDelay = atoi(value);
         } else if (strcasecmp(option, "interiodelay") == 0) {
                 params->interIODelay = atoi(value);
+        } else if (strcasecmp(option, "computeoverlapus") == 0) {
+                params->computeOverlapUs = atoi(value);
         } else if (strcasecmp(option, "readfile") == 0) {
                 params->readFile = atoi(value);
         } else if (strcasecmp(option, "writefile") == 0) {
@@ -208,6 +249,10 @@ void DecodeDirective(char *line, IOR_param_t *params, options_all_t * module_opt
                 params->blockSize = string_to_bytes(value);
         } else if (strcasecmp(option, "transfersize") == 0) {
                 params->transferSize = string_to_bytes(value);
+        } else if (strcasecmp(option, "queuedepth") == 0) {
+                params->queueDepth = atoi(value);
+        } else if (strcasecmp(option, "threadsperrank") == 0) {
+                params->threadsPerRank = atoi(value);
         } else if (strcasecmp(option, "singlexferattempt") == 0) {
                 params->singleXferAttempt = atoi(value);
         } else if (strcasecmp(option, "intraTestBarriers") == 0) {
@@ -447,7 +492,7 @@ option_help * createGlobalOptions(IOR_param_t * params){
     {'j', NULL,        "outlierThreshold -- warn on outlier N seconds from mean", OPTION_OPTIONAL_ARGUMENT, 'd', & params->outlierThreshold},
     {'k', NULL,        "keepFile -- don't remove the test file(s) on program exit", OPTION_FLAG, 'd', & params->keepFile},
     {'K', NULL,        "keepFileWithError  -- keep error-filled file(s) after data-checking", OPTION_FLAG, 'd', & params->keepFileWithError},
-    {'l', "dataPacketType",        "datapacket type-- type of packet that will be created [offset|incompressible|timestamp|random|o|i|t|r]", OPTION_OPTIONAL_ARGUMENT, 's', &  params->buffer_type},
+    {'l', "dataPacketType",        "datapacket type-- type of packet that will be created [offset|incompressible|timestamp|random|compressible|o|i|t|r|c]", OPTION_OPTIONAL_ARGUMENT, 's', &  params->buffer_type},
     {'m', NULL,        "multiFile -- use number of reps (-i) for multiple file count", OPTION_FLAG, 'd', & params->multiFile},
     {'M', NULL,        "memoryPerNode -- hog memory on the node  (e.g.: 2g, 75%)", OPTION_OPTIONAL_ARGUMENT, 's', & params->memoryPerNodeStr},
     {'N', NULL,        "numTasks -- number of tasks that are participating in the test (overrides MPI)", OPTION_OPTIONAL_ARGUMENT, 'd', & params->numTasks},
@@ -470,12 +515,15 @@ option_help * createGlobalOptions(IOR_param_t * params){
     {'z', NULL,        "randomOffset -- access is to shuffled, not sequential, offsets within a file, specify twice for random (potentially overlapping)", OPTION_FLAG, 'd', & params->randomOffset},
     {0, "randomPrefill", "For random -z access only: Prefill the file with this blocksize, e.g., 2m", OPTION_OPTIONAL_ARGUMENT, 'l', & params->randomPrefillBlocksize},
     {0, "random-offset-seed",        "The seed for -z", OPTION_OPTIONAL_ARGUMENT, 'd', & params->randomSeed},
+    {0, "queue-depth", "Number of transfers each task keeps in flight, each uses its own transfer buffer; 0 uses the default of the API", OPTION_OPTIONAL_ARGUMENT, 'd', & params->queueDepth},
+    {0, "compute-overlap-us", "Compute for N us between posting each transfer and waiting for it, to measure how much I/O overlaps with computation", OPTION_OPTIONAL_ARGUMENT, 'd', & params->computeOverlapUs},
+    {0, "threads-per-rank", "Number of threads each task uses to issue transfers, the offsets of a task are split among them", OPTION_OPTIONAL_ARGUMENT, 'd', & params->threadsPerRank},
     {'Z', NULL,        "reorderTasksRandom -- changes task ordering to random select regions for readback, use twice for shuffling", OPTION_FLAG, 'd', & params->reorderTasksRandom},
     {0, "warningAsErrors",        "Any warning should lead to an error.", OPTION_FLAG, 'd', & params->warningAsErrors},
     {.help="  -O summaryFile=FILE                 -- store result data into this file", .arg = OPTION_OPTIONAL_ARGUMENT},
     {.help="  -O summaryFormat=[default,JSON,CSV] -- use the format for outputting the summary", .arg = OPTION_OPTIONAL_ARGUMENT},
     {.help="  -O saveRankPerformanceDetailsCSV=<FILE> -- store the performance of each rank into the named CSV file.", .arg = OPTION_OPTIONAL_ARGUMENT},
-    {.help="  -O savePerOpDataCSV=<FILE> -- store the performance of each rank into an individual file prefixed with this option.", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O savePerOpDataCSV=<FILE> -- store the time, latency, offset and size of each operation of each rank into an individual binary trace file prefixed with this option; convert it with contrib/optrace2csv.", .arg = OPTION_OPTIONAL_ARGUMENT},
     {0, "dryRun",      "do not perform any I/Os just run evtl. inputs print dummy output", OPTION_FLAG, 'd', & params->dryRun},
     LAST_OPTION,
   };
@@ -509,6 +557,7 @@ IOR_test_t *ParseCommandLine(int argc, char **argv, MPI_Comm com)
       AllocResults(tests);
     }
 
+    tests = ExpandSweeps(tests);
     CheckRunSettings(tests);
 
     return (tests);
@@ -0,0 +1,83 @@
+/*
+ * Checks the data pattern engine and reports its throughput per core.
+ * Usage: testpattern [transfer size in bytes] [seconds per measurement]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../utilities.h"
+
+static const char * type_names[] = {"timestamp", "offset", "incompressible", "random", "compressible"};
+
+static double now(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, & ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* returns the number of errors */
+static int check_pattern(char * buf, size_t size, ior_dataPacketType_e type){
+  int errors = 0;
+  generate_memory_pattern(buf, size, 42, 3, type, IOR_MEMORY_TYPE_CPU);
+  update_write_memory_pattern(4711, buf, size, 42, 3, type, IOR_MEMORY_TYPE_CPU);
+  if(verify_memory_pattern(4711, buf, size, 42, 3, type, IOR_MEMORY_TYPE_CPU) != 0){
+    fprintf(stderr, "%s: valid buffer of %zu bytes reported as corrupted\n", type_names[type], size);
+    errors++;
+  }
+  for(size_t pos = 0; pos < size; pos += size / 5 + 1){
+    buf[pos] ^= 0x10;
+    if(verify_memory_pattern(4711, buf, size, 42, 3, type, IOR_MEMORY_TYPE_CPU) == 0){
+      fprintf(stderr, "%s: corruption at byte %zu of %zu not detected\n", type_names[type], pos, size);
+      errors++;
+    }
+    buf[pos] ^= 0x10;
+  }
+  if(type != DATA_TIMESTAMP && verify_memory_pattern(4712, buf, size, 42, 3, type, IOR_MEMORY_TYPE_CPU) == 0){
+    fprintf(stderr, "%s: wrong offset not detected\n", type_names[type]);
+    errors++;
+  }
+  return errors;
+}
+
+/* GB/s for the given operation: 0 generate, 1 update, 2 verify */
+static double measure(char * buf, size_t size, ior_dataPacketType_e type, int op, double runtime){
+  size_t iterations = 0;
+  double start = now();
+  double end;
+  generate_memory_pattern(buf, size, 42, 3, type, IOR_MEMORY_TYPE_CPU);
+  do{
+    for(int i = 0; i < 16; i++, iterations++){
+      switch(op){
+        case 0: generate_memory_pattern(buf, size, 42, 3, type, IOR_MEMORY_TYPE_CPU); break;
+        case 1: update_write_memory_pattern(iterations, buf, size, 42, 3, type, IOR_MEMORY_TYPE_CPU); break;
+        case 2: verify_memory_pattern(iterations, buf, size, 42, 3, type, IOR_MEMORY_TYPE_CPU); break;
+      }
+    }
+    end = now();
+  }while(end - start < runtime);
+  return iterations * (double) size / (end - start) / 1e9;
+}
+
+int main(int argc, char ** argv){
+  size_t size = argc > 1 ? strtoull(argv[1], NULL, 10) : 1024 * 1024;
+  double runtime = argc > 2 ? atof(argv[2]) : 0.05;
+  size_t check_sizes[] = {8, 100, 4096, 4096 * 3 + 24, 65536};
+  int errors = 0;
+  char * buf = malloc(size > 65536 ? size : 65536);
+
+  for(int type = DATA_TIMESTAMP; type <= DATA_COMPRESSIBLE; type++){
+    for(int i = 0; i < sizeof(check_sizes) / sizeof(size_t); i++){
+      errors += check_pattern(buf, check_sizes[i], type);
+    }
+  }
+
+  printf("%-15s %12s %12s %12s (GB/s per core, %zu bytes per transfer)\n", "type", "generate", "update", "verify", size);
+  for(int type = DATA_TIMESTAMP; type <= DATA_COMPRESSIBLE; type++){
+    printf("%-15s %12.2f %12.2f %12.2f\n", type_names[type],
+      measure(buf, size, type, 0, runtime), measure(buf, size, type, 1, runtime), measure(buf, size, type, 2, runtime));
+  }
+  free(buf);
+  return errors != 0;
+}
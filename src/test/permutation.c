@@ -0,0 +1,83 @@
+/*
+ * Checks that random_permutation_get() is a bijection determined by the seed
+ * and reports the time per element.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../utilities.h"
+
+static double now(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, & ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* returns the number of errors */
+static int check_bijection(uint64_t count, uint64_t seed){
+  random_permutation_t perm;
+  char * seen = calloc(count, 1);
+  int errors = 0;
+  random_permutation_init(& perm, count, seed);
+  for(uint64_t i = 0; i < count; i++){
+    uint64_t v = random_permutation_get(& perm, i);
+    if(v >= count || seen[v]){
+      fprintf(stderr, "count %llu seed %llu: index %llu maps to invalid or duplicate value %llu\n",
+        (unsigned long long) count, (unsigned long long) seed, (unsigned long long) i, (unsigned long long) v);
+      errors++;
+      break;
+    }
+    seen[v] = 1;
+  }
+  free(seen);
+  return errors;
+}
+
+/* the same seed must give the same order, another seed a different one */
+static int check_seed(uint64_t count){
+  random_permutation_t a, b, c;
+  int same = 1;
+  int differs = 0;
+  random_permutation_init(& a, count, 4711);
+  random_permutation_init(& b, count, 4711);
+  random_permutation_init(& c, count, 4712);
+  for(uint64_t i = 0; i < count; i++){
+    uint64_t v = random_permutation_get(& a, i);
+    same &= v == random_permutation_get(& b, i);
+    differs |= v != random_permutation_get(& c, i);
+  }
+  if(! same || ! differs){
+    fprintf(stderr, "count %llu: permutation is not determined by the seed\n", (unsigned long long) count);
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char ** argv){
+  uint64_t check_counts[] = {1, 2, 3, 4, 5, 17, 64, 100, 1000, 4097, 65536, 1000003};
+  int errors = 0;
+
+  for(int i = 0; i < sizeof(check_counts) / sizeof(uint64_t); i++){
+    for(uint64_t seed = 0; seed < 3; seed++){
+      errors += check_bijection(check_counts[i], seed);
+    }
+  }
+  errors += check_seed(1000);
+
+  /* 2^40 transfers, e.g., 4 PiB in 4 KiB transfers */
+  random_permutation_t perm;
+  uint64_t count = 1ull << 40;
+  uint64_t sum = 0;
+  int iterations = 10000000;
+  random_permutation_init(& perm, count, 42);
+  double start = now();
+  for(int i = 0; i < iterations; i++){
+    sum += random_permutation_get(& perm, (uint64_t) i * 104729 % count);
+  }
+  double runtime = now() - start;
+  printf("%.1f ns per element for %llu elements (checksum %llu)\n", runtime / iterations * 1e9,
+    (unsigned long long) count, (unsigned long long) sum);
+  return errors != 0;
+}
@@ -36,6 +36,8 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
+#include <assert.h>
+#include <pthread.h>
 
 #ifdef HAVE_CUDA
 #include <cuda_runtime.h>
@@ -81,6 +83,127 @@ enum OutputFormat_t outputFormat;
 
 /***************************** F U N C T I O N S ******************************/
 
+/*
+ * Kernels of the data pattern engine.  They work on blocks of 8 words using
+ * the vector extension of GCC/Clang; on x86-64 GCC builds a clone for
+ * AVX-512, AVX2 and the SSE2 baseline and picks one at load time.
+ */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#  define PATTERN_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#  define PATTERN_KERNEL
+#endif
+
+#if defined(__GNUC__)
+typedef uint64_t pattern_vec_t __attribute__((vector_size(64)));
+#  define PATTERN_VEC_WORDS 8
+#endif
+
+/* buf[i] = hi | (start + i) */
+PATTERN_KERNEL static void pattern_fill_sequence(uint64_t * buf, size_t n, uint64_t hi, uint64_t start){
+  size_t i = 0;
+#ifdef PATTERN_VEC_WORDS
+  pattern_vec_t v = {0, 1, 2, 3, 4, 5, 6, 7};
+  const pattern_vec_t step = {8, 8, 8, 8, 8, 8, 8, 8};
+  v += start;
+  for(; i + PATTERN_VEC_WORDS <= n; i += PATTERN_VEC_WORDS){
+    pattern_vec_t w = v | hi;
+    memcpy(buf + i, & w, sizeof(w));
+    v += step;
+  }
+#endif
+  for(; i < n; i++){
+    buf[i] = hi | (start + i);
+  }
+}
+
+/* returns a non-zero value if any buf[i] != hi | (start + i) */
+PATTERN_KERNEL static uint64_t pattern_diff_sequence(const uint64_t * buf, size_t n, uint64_t hi, uint64_t start){
+  uint64_t diff = 0;
+  size_t i = 0;
+#ifdef PATTERN_VEC_WORDS
+  pattern_vec_t v = {0, 1, 2, 3, 4, 5, 6, 7};
+  const pattern_vec_t step = {8, 8, 8, 8, 8, 8, 8, 8};
+  pattern_vec_t d = {0};
+  v += start;
+  for(; i + PATTERN_VEC_WORDS <= n; i += PATTERN_VEC_WORDS){
+    pattern_vec_t w;
+    memcpy(& w, buf + i, sizeof(w));
+    d |= w ^ (v | hi);
+    v += step;
+  }
+  for(int j = 0; j < PATTERN_VEC_WORDS; j++){
+    diff |= d[j];
+  }
+#endif
+  for(; i < n; i++){
+    diff |= buf[i] ^ (hi | (start + i));
+  }
+  return diff;
+}
+
+/* buf[i] = value */
+PATTERN_KERNEL static void pattern_fill_constant(uint64_t * buf, size_t n, uint64_t value){
+  for(size_t i = 0; i < n; i++){
+    buf[i] = value;
+  }
+}
+
+/* returns a non-zero value if any buf[i] != value */
+PATTERN_KERNEL static uint64_t pattern_diff_constant(const uint64_t * buf, size_t n, uint64_t value){
+  uint64_t diff = 0;
+  size_t i = 0;
+#ifdef PATTERN_VEC_WORDS
+  pattern_vec_t d = {0};
+  for(; i + PATTERN_VEC_WORDS <= n; i += PATTERN_VEC_WORDS){
+    pattern_vec_t w;
+    memcpy(& w, buf + i, sizeof(w));
+    d |= w ^ value;
+  }
+  for(int j = 0; j < PATTERN_VEC_WORDS; j++){
+    diff |= d[j];
+  }
+#endif
+  for(; i < n; i++){
+    diff |= buf[i] ^ value;
+  }
+  return diff;
+}
+
+/*
+ * buf[i] = hi + ((start + i) << 16) | noise: word i of a DATA_COMPRESSIBLE
+ * buffer mimics a smooth field of measurements, the upper six bytes change
+ * slowly while the lowest two are pseudo-random.  Deflate reaches about
+ * 2:1, with byte shuffling about 4:1.
+ */
+static uint64_t pattern_compressible(uint64_t * buf, size_t n, uint64_t hi, uint64_t start, uint64_t seed, int verify){
+  uint64_t state = seed * RANDALGO_GOLDEN_RATIO_PRIME + 1;
+  uint64_t diff = 0;
+  for(size_t i = 0; i < n; i++){
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    uint64_t word = (hi + ((start + i) << 16)) | (state >> 48);
+    if(verify){
+      diff |= buf[i] ^ word;
+    }else{
+      buf[i] = word;
+    }
+  }
+  return diff;
+}
+
+/* the word DATA_INCOMPRESSIBLE repeats, derived from the seed with rand_r() */
+static uint64_t pattern_incompressible_word(int rand_seed, int pretendRank){
+  unsigned seed = rand_seed + pretendRank;
+  uint64_t hi = ((uint64_t) rand_r(& seed) << 32);
+  uint64_t lo = (uint64_t) rand_r(& seed);
+  return hi | lo;
+}
+
+/* the first word of every 4 KiB block carries the item (offset) and the rank */
+static inline uint64_t pattern_item_word(uint64_t item, int k, int pretendRank){
+  return ((uint32_t) item * k) | ((uint64_t) pretendRank) << 32;
+}
+
 /**
  * Modifies a buffer for a write.  Performance sensitive because it is called
  * before each write.
@@ -116,11 +239,15 @@ void update_write_memory_pattern(uint64_t item, char * buf, size_t bytes, int ra
       }
       return;
   }
+  if (dataPacketType == DATA_COMPRESSIBLE) {
+      pattern_compressible(buffi, size, ((uint64_t) pretendRank) << 48, item / sizeof(uint64_t), rand_seed + pretendRank + item, 0);
+      return;
+  }
 
   /* DATA_INCOMPRESSIBLE and DATA_OFFSET */
   int k = 1;
   for(size_t i=0; i < size; i+=512, k++){
-    buffi[i] = ((uint32_t) item * k) | ((uint64_t) pretendRank) << 32;
+    buffi[i] = pattern_item_word(item, k, pretendRank);
   }
 }
 
@@ -145,25 +272,20 @@ void generate_memory_pattern(char * buf, size_t bytes, int rand_seed, int preten
   // first half of 64 bits use the rank
   const size_t size = bytes / 8;
   // the first 8 bytes of each 4k block are updated at runtime
-  for(size_t i=0; i < size; i++){
-    switch(dataPacketType){
-      case(DATA_RANDOM):
-        // Nothing to do, will work on updates
-        break;
-      case(DATA_INCOMPRESSIBLE):{
-        unsigned seed = rand_seed + pretendRank;
-        uint64_t hi = ((uint64_t) rand_r(& seed) << 32);
-        uint64_t lo = (uint64_t) rand_r(& seed);
-        buffi[i] = hi | lo;
-        break;
-      }case(DATA_OFFSET):{
-      }case(DATA_TIMESTAMP):{
-        buffi[i] = ((uint64_t) pretendRank) << 32 | rand_seed + i;
-        break;
-      }
-    }
+  switch(dataPacketType){
+    case(DATA_RANDOM):
+    case(DATA_COMPRESSIBLE):
+      // Nothing to do, will work on updates
+      break;
+    case(DATA_INCOMPRESSIBLE):
+      pattern_fill_constant(buffi, size, pattern_incompressible_word(rand_seed, pretendRank));
+      break;
+    case(DATA_OFFSET):
+    case(DATA_TIMESTAMP):
+      pattern_fill_sequence(buffi, size, ((uint64_t) pretendRank) << 32, (uint64_t) rand_seed);
+      break;
   }
-  
+
   for(size_t i=size*8; i < bytes; i++){
     buf[i] = (char) i;
   }
@@ -189,43 +311,39 @@ int verify_memory_pattern(uint64_t item, char * buffer, size_t bytes, int rand_s
 #endif
   // always read all data to ensure that performance numbers stay the same
   uint64_t * buffi = (uint64_t*) buffer;
-    
-  // the first 8 bytes are set to item number
-  int k=1;  
-  
-  uint64_t rand_state_local;
-  unsigned seed = rand_seed + pretendRank + item;
-  rand_state_local = rand_r(&seed);
   const size_t size = bytes / 8;
-  for(size_t i=0; i < size; i++){
-    uint64_t exp;
-        
-    switch(dataPacketType){
-      case(DATA_RANDOM):
-        rand_state_local *= RANDALGO_GOLDEN_RATIO_PRIME;
-        rand_state_local >>= 3;
-        exp = rand_state_local;
-        break;
-      case(DATA_INCOMPRESSIBLE):{
-        unsigned seed = rand_seed + pretendRank;
-        uint64_t hi = ((uint64_t) rand_r(& seed) << 32);
-        uint64_t lo = (uint64_t) rand_r(& seed);
-        exp = hi | lo;
-        break;
-      }case(DATA_OFFSET):{
-      }case(DATA_TIMESTAMP):{
-        exp = ((uint64_t) pretendRank) << 32 | rand_seed + i;
-        break;
-      }
-    }
-    if(i % 512 == 0 && (dataPacketType != DATA_TIMESTAMP) && dataPacketType != DATA_RANDOM){
-      exp = ((uint32_t) item * k) | ((uint64_t) pretendRank) << 32;
-      k++;
+  uint64_t diff = 0;
+
+  if(dataPacketType == DATA_RANDOM){
+    uint64_t rand_state_local;
+    unsigned seed = rand_seed + pretendRank + item;
+    rand_state_local = rand_r(&seed);
+    for(size_t i=0; i < size; i++){
+      rand_state_local *= RANDALGO_GOLDEN_RATIO_PRIME;
+      rand_state_local >>= 3;
+      diff |= buffi[i] ^ rand_state_local;
     }
-    if(buffi[i] != exp){
-      error = 1;
+  }else if(dataPacketType == DATA_COMPRESSIBLE){
+    diff = pattern_compressible(buffi, size, ((uint64_t) pretendRank) << 48, item / sizeof(uint64_t), rand_seed + pretendRank + item, 1);
+  }else if(dataPacketType == DATA_TIMESTAMP){
+    diff = pattern_diff_sequence(buffi, size, ((uint64_t) pretendRank) << 32, (uint64_t) rand_seed);
+  }else{
+    // the first 8 bytes of each 4 KiB block are set to the item number
+    const uint64_t value = dataPacketType == DATA_INCOMPRESSIBLE ? pattern_incompressible_word(rand_seed, pretendRank) : 0;
+    int k=1;
+    for(size_t i=0; i < size; i+=512, k++){
+      size_t n = size - i - 1 < 511 ? size - i - 1 : 511;
+      diff |= buffi[i] ^ pattern_item_word(item, k, pretendRank);
+      if(dataPacketType == DATA_INCOMPRESSIBLE){
+        diff |= pattern_diff_constant(buffi + i + 1, n, value);
+      }else{
+        diff |= pattern_diff_sequence(buffi + i + 1, n, ((uint64_t) pretendRank) << 32, (uint64_t) rand_seed + i + 1);
+      }
     }
   }
+  if(diff != 0){
+    error = 1;
+  }
   for(size_t i=size*8; i < bytes; i++){
     if(buffer[i] != (char) i){
       error = 1;
@@ -235,17 +353,115 @@ int verify_memory_pattern(uint64_t item, char * buffer, size_t bytes, int rand_s
   return error;
 }
 
-/* Data structure to store information about per-operation timer */
+static uint64_t permutation_mix(uint64_t z){
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+void random_permutation_init(random_permutation_t * perm, uint64_t count, uint64_t seed){
+  int bits = 0;
+  while(bits < 64 && (count - 1) >> bits){
+    bits++;
+  }
+  perm->count = count;
+  perm->half_bits = bits < 2 ? 1 : (bits + 1) / 2;
+  perm->half_mask = (1ull << perm->half_bits) - 1;
+  for(int i = 0; i < 4; i++){
+    perm->keys[i] = permutation_mix(seed + (i + 1) * 0x9e3779b97f4a7c15ull);
+  }
+}
+
+static uint64_t permutation_encrypt(const random_permutation_t * perm, uint64_t value){
+  uint64_t left = value >> perm->half_bits;
+  uint64_t right = value & perm->half_mask;
+  for(int i = 0; i < 4; i++){
+    uint64_t tmp = right;
+    right = left ^ (permutation_mix(right ^ perm->keys[i]) & perm->half_mask);
+    left = tmp;
+  }
+  return (left << perm->half_bits) | right;
+}
+
+uint64_t random_permutation_get(const random_permutation_t * perm, uint64_t index){
+  assert(index < perm->count);
+  /* the network permutes the 4^half_bits values, less than 4 * count,
+   * so a value < count is reached after a few rounds on average */
+  do{
+    index = permutation_encrypt(perm, index);
+  }while(index >= perm->count);
+  return index;
+}
+
+/*
+ * Per-operation trace, a binary file with a header followed by one record per
+ * operation. All integers are little endian.
+ * Header: "IORTRACE", uint32 version (1), uint32 flags (0), uint64 default size
+ * Record: four LEB128 varints
+ *   start time in ns, zigzag encoded difference to the previous start time
+ *   latency in ns
+ *   offset, zigzag encoded difference to the end (offset + size) of the previous record
+ *   size in bytes
+ * contrib/optrace2csv converts a trace to CSV.
+ * Records are collected in one of two buffers, a full buffer is written by a
+ * separate thread while the other one is filled.
+ */
+#define OP_TRACE_VERSION 1
+#define OP_BUFFER_SIZE (256 * 1024)
+#define OP_RECORD_MAX_SIZE 40
+
 struct OpTimer{
     FILE * fd;
-    int size; /* per op */
-    double * time;
-    double * value;
-    int pos;
+    int64_t size; /* default size per op */
+    unsigned char * buf[2];
+    int active; /* the buffer that is filled */
+    size_t pos;
+    int64_t last_time;
+    int64_t next_offset;
+
+    /* shared with the writer thread */
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    unsigned char * write_buf;
+    size_t write_len; /* 0 if the writer is idle */
+    int done;
 };
 
-/* by default store 1M operations into the buffer before flushing */
-#define OP_BUFFER_SIZE 1000000
+static void * OpTimerWriter(void * arg){
+  OpTimer * ot = (OpTimer*) arg;
+  pthread_mutex_lock(& ot->lock);
+  while(1){
+    while(ot->write_len == 0 && ! ot->done){
+      pthread_cond_wait(& ot->cond, & ot->lock);
+    }
+    if(ot->write_len == 0){
+      break;
+    }
+    pthread_mutex_unlock(& ot->lock);
+    if(fwrite(ot->write_buf, ot->write_len, 1, ot->fd) != 1){
+      WARN("Cannot write to OpTimer file");
+    }
+    pthread_mutex_lock(& ot->lock);
+    ot->write_len = 0;
+    pthread_cond_broadcast(& ot->cond);
+  }
+  pthread_mutex_unlock(& ot->lock);
+  return NULL;
+}
+
+static unsigned char * put_varint(unsigned char * p, uint64_t v){
+  while(v >= 0x80){
+    *p++ = (unsigned char) (v | 0x80);
+    v >>= 7;
+  }
+  *p++ = (unsigned char) v;
+  return p;
+}
+
+static uint64_t zigzag(int64_t v){
+  return ((uint64_t) v << 1) ^ (uint64_t) (v >> 63);
+}
 
 OpTimer* OpTimerInit(char * filename, int size){
   if(filename == NULL) {
@@ -253,53 +469,90 @@ OpTimer* OpTimerInit(char * filename, int size){
   }
   OpTimer * ot = safeMalloc(sizeof(OpTimer));
   ot->size = size;
-  ot->value = safeMalloc(sizeof(double)*OP_BUFFER_SIZE);
-  ot->time = safeMalloc(sizeof(double)*OP_BUFFER_SIZE);
-  ot->pos = 0;
+  ot->buf[0] = safeMalloc(OP_BUFFER_SIZE);
+  ot->buf[1] = safeMalloc(OP_BUFFER_SIZE);
   ot->fd = fopen(filename, "w");
-  if(ot->fd < 0){
-    ERR("Could not create OpTimer");
+  if(ot->fd == NULL){
+    ERRF("Could not create OpTimer file %s: %s", filename, strerror(errno));
   }
-  char buff[] = "time,runtime,tp\n";
-  int ret = fwrite(buff, strlen(buff), 1, ot->fd);
+  unsigned char header[24] = "IORTRACE";
+  uint32_t version = OP_TRACE_VERSION;
+  uint64_t default_size = size;
+  for(int i = 0; i < 4; i++){
+    header[8 + i] = (unsigned char) (version >> (8 * i));
+  }
+  for(int i = 0; i < 8; i++){
+    header[16 + i] = (unsigned char) (default_size >> (8 * i));
+  }
+  int ret = fwrite(header, sizeof(header), 1, ot->fd);
   if(ret != 1){
     FAIL("Cannot write header to OpTimer file");
   }
+  pthread_mutex_init(& ot->lock, NULL);
+  pthread_cond_init(& ot->cond, NULL);
+  if(pthread_create(& ot->writer, NULL, OpTimerWriter, ot) != 0){
+    ERR("Cannot create OpTimer writer thread");
+  }
   return ot;
 }
 
+/* hand the filled buffer to the writer thread, waits until the previous one is written */
 void OpTimerFlush(OpTimer* ot){
-  if(ot == NULL) {
+  if(ot == NULL || ot->pos == 0) {
     return;
-  }  
-  for(int i=0; i < ot->pos; i++){
-    fprintf(ot->fd, "%.8e,%.8e,%e\n", ot->time[i], ot->value[i], ot->size/ot->value[i]);
   }
+  pthread_mutex_lock(& ot->lock);
+  while(ot->write_len != 0){
+    pthread_cond_wait(& ot->cond, & ot->lock);
+  }
+  ot->write_buf = ot->buf[ot->active];
+  ot->write_len = ot->pos;
+  pthread_cond_broadcast(& ot->cond);
+  pthread_mutex_unlock(& ot->lock);
+  ot->active = ! ot->active;
   ot->pos = 0;
 }
 
-void OpTimerValue(OpTimer* ot, double now, double runTime){
+void OpTimerRecord(OpTimer* ot, double now, double runTime, int64_t offset, int64_t size){
   if(ot == NULL) {
     return;
-  }  
-  ot->time[ot->pos] = now;
-  ot->value[ot->pos++] = runTime;
-  if(ot->pos == OP_BUFFER_SIZE){
+  }
+  int64_t time = (int64_t) (now * 1e9);
+  unsigned char * p = ot->buf[ot->active] + ot->pos;
+  p = put_varint(p, zigzag(time - ot->last_time));
+  p = put_varint(p, runTime > 0 ? (uint64_t) (runTime * 1e9) : 0);
+  p = put_varint(p, zigzag(offset - ot->next_offset));
+  p = put_varint(p, size);
+  ot->pos = p - ot->buf[ot->active];
+  ot->last_time = time;
+  ot->next_offset = offset + size;
+  if(ot->pos > OP_BUFFER_SIZE - OP_RECORD_MAX_SIZE){
     OpTimerFlush(ot);
   }
 }
 
+void OpTimerValue(OpTimer* ot, double now, double runTime){
+  if(ot == NULL) {
+    return;
+  }
+  OpTimerRecord(ot, now, runTime, ot->next_offset, ot->size);
+}
+
 void OpTimerFree(OpTimer** otp){
   if(otp == NULL || *otp == NULL) {
     return;
   }
   OpTimer * ot = *otp;
   OpTimerFlush(ot);
-  ot->pos = 0;
-  free(ot->value);
-  free(ot->time);
-  ot->value = NULL;
-  ot->time = NULL;
+  pthread_mutex_lock(& ot->lock);
+  ot->done = 1;
+  pthread_cond_broadcast(& ot->cond);
+  pthread_mutex_unlock(& ot->lock);
+  pthread_join(ot->writer, NULL);
+  pthread_mutex_destroy(& ot->lock);
+  pthread_cond_destroy(& ot->cond);
+  free(ot->buf[0]);
+  free(ot->buf[1]);
   fclose(ot->fd);
   free(ot);
   *otp = NULL;
@@ -369,6 +622,8 @@ ior_dataPacketType_e parsePacketType(char t){
             return DATA_OFFSET;
     case 'r': /* randomized blocks */
             return DATA_RANDOM;
+    case 'c': /* compressible values */
+            return DATA_COMPRESSIBLE;
     default:
       ERRF("Unknown packet type \"%c\"; generic assumed\n", t);
       return DATA_OFFSET;
@@ -64,9 +64,26 @@ void DelaySecs(int delay);
 void updateParsedOptions(IOR_param_t * options, options_all_t * global_options);
 size_t NodeMemoryStringToBytes(char *size_str);
 
+/*
+ * Pseudo-random permutation of [0, count) determined by the seed, the element
+ * at an index is computed in O(1) memory (a Feistel network over the next
+ * power of four, cycle walking skips values >= count).
+ */
+typedef struct {
+  uint64_t count;
+  uint64_t half_mask;
+  int half_bits;
+  uint64_t keys[4];
+} random_permutation_t;
+void random_permutation_init(random_permutation_t * perm, uint64_t count, uint64_t seed);
+uint64_t random_permutation_get(const random_permutation_t * perm, uint64_t index);
+
+/* binary per-operation trace, see contrib/optrace2csv to convert it to CSV */
 typedef struct OpTimer OpTimer;
 OpTimer* OpTimerInit(char * filename, int size);
+/* record an operation of the default size that directly follows the previous one */
 void OpTimerValue(OpTimer* otimer_in, double now, double runTime);
+void OpTimerRecord(OpTimer* otimer_in, double now, double runTime, int64_t offset, int64_t size);
 void OpTimerFlush(OpTimer* otimer_in);
 void OpTimerFree(OpTimer** otimer_in);
 
@@ -16,6 +16,31 @@ IOR 2 -a POSIX -w     -C              -k -e -i1 -m -t 100k -b 200k
 # Random read the file previously created
 IOR 2 -a POSIX -r                     -k -e -i1 -m -t 100k -b 200k -s 10 -z -z
 
+IOR 2 -a POSIX -w -W -r -R -C --queue-depth=4 -F -k -e -i1 -m -t 100k -b 400k -G 3
+IOR 2 -a POSIX -w -W -r -R -C --threads-per-rank=4 -k -e -i1 -m -t 100k -b 400k -G 3
+IOR 2 -a POSIX -w -W -r -R -C --posix.vectored=8 -k -e -i1 -m -t 100k -b 1600k -G 3
+IOR 2 -a POSIX -w -r -R -C -l c -k -e -i1 -m -t 100k -b 400k
+IOR 2 -a MMAP -w -r -R -F -k -e -i1 -m -t 64k -b 1m --mmap.window=256k --mmap.prefetch=512k
+IOR 2 -a MPIIO -w -r -R -C -k -e -i1 -m -t 100k -b 400k --mpiio.nonblocking=4 --compute-overlap-us=10
+IOR 2 -a MPIIO -c -w -r -R -C -k -e -i1 -m -t 100k -b 400k --mpiio.useFileView --mpiio.cbNodes=1,2 --mpiio.cbMode=enable,disable
+
+MDTEST 1 -a POSIX -n 2000 -w 100 -e 100 -X --md-concurrency=4
+MDTEST 2 -a POSIX -z 2 -b 3 -n 60 -u --md-concurrency=4
+MDTEST 1 -a DUMMY -n 100000 -z 3 -b 4 -F -u -R --random-seed=42
+MDTEST 2 -a POSIX -c --collective-aggregators=2 -z 1 -b 2 -n 40 -u
+MDTEST 2 -a POSIX --md-batch=8 -z 1 -b 2 -n 40
+MDTEST 2 -a POSIX --posix.dirfd-cache=4 -z 2 -b 2 -n 40 -i 2
+
+MDWB 2 -a POSIX -O=1 -D=2 -G=3 -P=8 -I=4 -R=2 -X --concurrency=4
+
+# HDF5 event-set and multi-dataset transfers, if the library provides them
+if ${IOR_BIN_DIR}/ior -h 2>&1 | grep -q -- --hdf5.async ; then
+  IOR 2 -a HDF5 -w -r -R -k -e -i1 -m -t 100k -b 400k --hdf5.async=4
+fi
+if ${IOR_BIN_DIR}/ior -h 2>&1 | grep -q -- --hdf5.multiDataset ; then
+  IOR 2 -a HDF5 -w -r -R -k -e -i1 -m -t 100k -b 400k --hdf5.multiDataset=4
+fi
+
 exit 1
 
 MDTEST 1 -a POSIX
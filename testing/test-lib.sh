@@ -69,6 +69,10 @@ function MDTEST(){
   else
     # compare basic pattern
     grep "V-3" "${IOR_OUT}/test_out.$I" | sed "s/Line *[0-9]*//" > "${IOR_OUT}/tmp"
+    # the worker threads of --md-concurrency process the items in any order
+    if [[ "$*" == *--md-concurrency* ]] ; then
+      sort -o "${IOR_OUT}/tmp" "${IOR_OUT}/tmp"
+    fi
     if [[ -r ${MDTEST_TEST_PATTERNS}/$I.txt ]] ; then
       cmp -s "${IOR_OUT}/tmp" ${MDTEST_TEST_PATTERNS}/$I.txt
       if [[ $? != 0 ]]; then